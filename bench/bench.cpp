@@ -0,0 +1,478 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "harness.hpp"
+#include "zip_utils/zip_utils.hpp"
+
+using namespace zip_utils::views;
+using zip_utils::bench::do_not_optimize;
+using zip_utils::bench::registry;
+using zip_utils::bench::result;
+using zip_utils::configuration::zip_config;
+
+
+namespace {
+
+    template <std::size_t Size>
+    struct blob {
+        std::array<std::uint8_t, Size> bytes{};
+    };
+
+    template <std::size_t Size>
+    std::uint64_t first_byte(blob<Size> const &value) {
+        return value.bytes[0];
+    }
+
+    std::uint64_t first_byte(std::uint64_t value) {
+        return value;
+    }
+
+    template <typename Key, typename Value>
+    std::uint64_t first_byte(std::pair<Key const, Value> const &value) {
+        return first_byte(value.second);
+    }
+
+    constexpr std::size_t array_elements = 1024;
+
+    // Keeps every column of a benchmark within a few megabytes
+    template <typename Value>
+    std::size_t elements_for(std::size_t requested) {
+        return std::max<std::size_t>(1, std::min(requested, (std::size_t{4} << 20) / sizeof(Value)));
+    }
+
+    template <template <typename...> typename Sequence, typename Value>
+    Sequence<Value> make_sequence(std::size_t n) {
+        Sequence<Value> result;
+        for (std::size_t i = 0; i < n; ++i) {
+            Value value{};
+            value.bytes[0] = static_cast<std::uint8_t>(i);
+            result.push_back(value);
+        }
+        return result;
+    }
+
+    template <typename Container>
+    struct columns_of {
+        std::vector<Container> columns;
+        std::size_t elements;
+    };
+
+    template <typename Container, std::size_t Columns, typename Sum>
+    void run_kernel(registry &reg, std::string_view container, std::string_view variant, std::size_t element_size,
+                    columns_of<Container> &fixture, Sum &&sum) {
+        auto name = std::string(container) + "/" + std::to_string(Columns) + "x" + std::to_string(element_size) + "B/" +
+                    std::string(variant);
+        reg.run(result{std::move(name), std::string(container), std::string(variant), Columns, element_size,
+                       fixture.elements, 0, 0.0},
+                [&] { do_not_optimize(sum()); });
+    }
+
+    // Sum of the first byte of every element, written with zip and with the hand-written alternatives
+    template <std::size_t Columns, typename Container>
+    void bench_columns(registry &reg, std::string_view container, std::size_t element_size,
+                       columns_of<Container> &fixture) {
+        auto &cols = fixture.columns;
+        auto const n = fixture.elements;
+
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            run_kernel<Container, Columns>(reg, container, "zip", element_size, fixture, [&] {
+                std::uint64_t sum = 0;
+                for (auto const &row : zip(cols[I]...)) {
+                    sum += (first_byte(row.template get<I>()) + ...);
+                }
+                return sum;
+            });
+
+            run_kernel<Container, Columns>(reg, container, "iterators", element_size, fixture, [&] {
+                std::uint64_t sum = 0;
+                auto its = std::tuple{std::ranges::begin(cols[I])...};
+                auto const last = std::ranges::end(cols[0]);
+                for (; std::get<0>(its) != last; (++std::get<I>(its), ...)) {
+                    sum += (first_byte(*std::get<I>(its)) + ...);
+                }
+                return sum;
+            });
+
+            if constexpr (std::ranges::random_access_range<Container>) {
+                run_kernel<Container, Columns>(reg, container, "index", element_size, fixture, [&] {
+                    std::uint64_t sum = 0;
+                    for (std::size_t i = 0; i < n; ++i) {
+                        sum += (first_byte(cols[I][i]) + ...);
+                    }
+                    return sum;
+                });
+            }
+
+            if constexpr (std::ranges::contiguous_range<Container>) {
+                run_kernel<Container, Columns>(reg, container, "pointer", element_size, fixture, [&] {
+                    std::uint64_t sum = 0;
+                    auto pointers = std::tuple{std::ranges::data(cols[I])...};
+                    auto const last = std::get<0>(pointers) + n;
+                    for (; std::get<0>(pointers) != last; (++std::get<I>(pointers), ...)) {
+                        sum += (first_byte(*std::get<I>(pointers)) + ...);
+                    }
+                    return sum;
+                });
+            }
+
+#if defined(__cpp_lib_ranges_zip)
+            run_kernel<Container, Columns>(reg, container, "std_views_zip", element_size, fixture, [&] {
+                std::uint64_t sum = 0;
+                for (auto const &row : std::views::zip(cols[I]...)) {
+                    sum += (first_byte(std::get<I>(row)) + ...);
+                }
+                return sum;
+            });
+#endif
+        }
+        (std::make_index_sequence<Columns>{});
+    }
+
+    template <typename Container, typename Make>
+    void bench_container(registry &reg, std::string_view container, std::size_t element_size, Make &&make) {
+        columns_of<Container> fixture{};
+        for (std::size_t i = 0; i < 8; ++i) {
+            fixture.columns.push_back(make());
+        }
+        fixture.elements = static_cast<std::size_t>(std::ranges::distance(fixture.columns[0]));
+
+        bench_columns<1>(reg, container, element_size, fixture);
+        bench_columns<2>(reg, container, element_size, fixture);
+        bench_columns<4>(reg, container, element_size, fixture);
+        bench_columns<8>(reg, container, element_size, fixture);
+    }
+
+    template <std::size_t Size>
+    void bench_element_size(registry &reg) {
+        using value = blob<Size>;
+        auto const n = elements_for<value>(reg.settings().elements);
+
+        bench_container<std::vector<value>>(reg, "vector", Size, [&] { return make_sequence<std::vector, value>(n); });
+        bench_container<std::deque<value>>(reg, "deque", Size, [&] { return make_sequence<std::deque, value>(n); });
+        bench_container<std::list<value>>(reg, "list", Size, [&] { return make_sequence<std::list, value>(n); });
+        bench_container<std::array<value, array_elements>>(reg, "array", Size, [] {
+            std::array<value, array_elements> result{};
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                result[i].bytes[0] = static_cast<std::uint8_t>(i);
+            }
+            return result;
+        });
+        bench_container<std::map<std::uint64_t, value>>(reg, "map", Size, [&] {
+            std::map<std::uint64_t, value> result;
+            for (std::size_t i = 0; i < n; ++i) {
+                result[i].bytes[0] = static_cast<std::uint8_t>(i);
+            }
+            return result;
+        });
+    }
+
+    void bench_sets(registry &reg) {
+        auto const n = elements_for<std::uint64_t>(reg.settings().elements);
+        bench_container<std::set<std::uint64_t>>(reg, "set", sizeof(std::uint64_t), [&] {
+            std::set<std::uint64_t> result;
+            for (std::size_t i = 0; i < n; ++i) {
+                result.insert(i);
+            }
+            return result;
+        });
+    }
+
+    void bench_enumerate(registry &reg) {
+        auto const n = elements_for<std::uint64_t>(reg.settings().elements);
+        std::vector<std::uint64_t> values(n, 3);
+        columns_of<std::vector<std::uint64_t>> fixture{{}, n};
+
+        run_kernel<std::vector<std::uint64_t>, 1>(reg, "vector", "enumerate", 8, fixture, [&] {
+            std::uint64_t sum = 0;
+            for (auto [i, x] : enumerate(values)) {
+                sum += i * x;
+            }
+            return sum;
+        });
+        run_kernel<std::vector<std::uint64_t>, 1>(reg, "vector", "enumerate_index", 8, fixture, [&] {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                sum += i * values[i];
+            }
+            return sum;
+        });
+
+        columns_of<std::array<std::uint64_t, 8>> small{{}, 8};
+        run_kernel<std::array<std::uint64_t, 8>, 1>(reg, "array", "indexed", 8, small, [] {
+            std::uint64_t sum = 0;
+            for (auto [i, x] : indexed(1, 2, 3, 4, 5, 6, 7, 8)) {
+                sum += i * static_cast<std::uint64_t>(x);
+            }
+            return sum;
+        });
+        run_kernel<std::array<std::uint64_t, 8>, 1>(reg, "array", "indexed_index", 8, small, [] {
+            std::array<int, 8> values = {1, 2, 3, 4, 5, 6, 7, 8};
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                sum += i * static_cast<std::uint64_t>(values[i]);
+            }
+            return sum;
+        });
+    }
+
+    // Consumes rvalue containers of strings, the refill of the inputs is part of every variant
+    template <zip_config Config>
+    void bench_rvalues(registry &reg, std::string_view variant) {
+        auto const n = elements_for<std::string>(reg.settings().elements) / 4;
+        std::vector<std::string> const prototype(n, std::string(48, 'x'));
+        columns_of<std::vector<std::string>> fixture{{}, n};
+
+        run_kernel<std::vector<std::string>, 2>(reg, "vector", variant, sizeof(std::string), fixture, [&] {
+            std::size_t sum = 0;
+            auto a = prototype;
+            auto b = prototype;
+            for (auto [x, y] : zip<Config>(std::move(a), std::move(b))) {
+                // Rows are references: the strings are copied or moved out like in the index loop
+                std::string s = std::forward<decltype(x)>(x);
+                std::string t = std::forward<decltype(y)>(y);
+                sum += s.size() + t.size();
+            }
+            return sum;
+        });
+    }
+
+    void bench_rvalues_index(registry &reg) {
+        auto const n = elements_for<std::string>(reg.settings().elements) / 4;
+        std::vector<std::string> const prototype(n, std::string(48, 'x'));
+        columns_of<std::vector<std::string>> fixture{{}, n};
+
+        run_kernel<std::vector<std::string>, 2>(reg, "vector", "rvalues_index_move", sizeof(std::string), fixture,
+                                                [&] {
+                                                    std::size_t sum = 0;
+                                                    auto a = prototype;
+                                                    auto b = prototype;
+                                                    for (std::size_t i = 0; i < n; ++i) {
+                                                        std::string x = std::move(a[i]);
+                                                        std::string y = std::move(b[i]);
+                                                        sum += x.size() + y.size();
+                                                    }
+                                                    return sum;
+                                                });
+    }
+
+    // Scatters rows of pairs into two vectors: unzip against a pass per column without reserving
+    void bench_unzip(registry &reg) {
+        auto const n = elements_for<std::pair<std::uint64_t, std::uint64_t>>(reg.settings().elements);
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> rows(n, {1, 2});
+        columns_of<std::vector<std::uint64_t>> fixture{{}, n};
+
+        run_kernel<std::vector<std::uint64_t>, 2>(reg, "vector", "unzip", 8, fixture, [&] {
+            std::vector<std::uint64_t> keys, values;
+            zip_utils::unzip(rows, keys, values);
+            return keys.back() + values.back();
+        });
+        run_kernel<std::vector<std::uint64_t>, 2>(reg, "vector", "unzip_per_column", 8, fixture, [&] {
+            std::vector<std::uint64_t> keys, values;
+            for (auto const &row : rows) {
+                keys.push_back(row.first);
+            }
+            for (auto const &row : rows) {
+                values.push_back(row.second);
+            }
+            return keys.back() + values.back();
+        });
+    }
+
+    // Node-based inputs larger than the cache, with nodes scattered in memory: the list is relinked in random
+    // order and the map gets its keys in random order, so every step is a likely cache miss
+    template <zip_config Config>
+    void bench_prefetch(registry &reg, std::string_view variant) {
+        auto const n = reg.settings().large_elements;
+        std::vector<std::uint64_t> keys(n);
+        std::iota(keys.begin(), keys.end(), 0);
+        std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+
+        std::list<std::uint64_t> list(keys.begin(), keys.end());
+        list.sort();
+        std::map<std::uint64_t, std::uint64_t> map;
+        for (auto key : keys) {
+            map.emplace(key, key);
+        }
+        std::vector<std::uint64_t> weights(n, 3);
+
+        columns_of<std::list<std::uint64_t>> lists{{}, n};
+        run_kernel<std::list<std::uint64_t>, 2>(reg, "list_large", variant, 8, lists, [&] {
+            std::uint64_t sum = 0;
+            for (auto const &[x, w] : zip<Config>(list, weights)) {
+                sum += x * w;
+            }
+            return sum;
+        });
+
+        columns_of<std::map<std::uint64_t, std::uint64_t>> maps{{}, n};
+        run_kernel<std::map<std::uint64_t, std::uint64_t>, 2>(reg, "map_large", variant, 8, maps, [&] {
+            std::uint64_t sum = 0;
+            for (auto const &[kv, x] : zip<Config>(map, list)) {
+                sum += kv.second ^ x;
+            }
+            return sum;
+        });
+    }
+
+    // Joins a sorted key column with a dense one and with a sparse one (one key in 1000): merge_join against
+    // a hand-written merge loop, which steps through the dense column also in the sparse case
+    void bench_merge_join(registry &reg) {
+        auto const n = elements_for<std::uint64_t>(reg.settings().elements);
+        std::vector<std::uint64_t> dense(n);
+        std::iota(dense.begin(), dense.end(), 0);
+        std::vector<std::uint64_t> halves, sparse;
+        for (std::uint64_t key = 0; key < 2 * n; key += 2) {
+            halves.push_back(key);
+        }
+        for (std::uint64_t key = 0; key < n; key += 1000) {
+            sparse.push_back(key);
+        }
+
+        auto const merge = [](auto const &left, auto const &right) {
+            std::uint64_t sum = 0;
+            auto l = left.begin();
+            auto r = right.begin();
+            while (l != left.end() && r != right.end()) {
+                if (*l < *r) {
+                    ++l;
+                } else if (*r < *l) {
+                    ++r;
+                } else {
+                    sum += *l;
+                    ++l;
+                    ++r;
+                }
+            }
+            return sum;
+        };
+        auto const join = [](auto const &left, auto const &right) {
+            std::uint64_t sum = 0;
+            for (auto const &[x, y] : merge_join(left, right)) {
+                sum += x;
+            }
+            return sum;
+        };
+
+        columns_of<std::vector<std::uint64_t>> fixture{{}, n};
+        run_kernel<std::vector<std::uint64_t>, 2>(reg, "vector", "merge_join_dense", 8, fixture,
+                                                  [&] { return join(halves, dense); });
+        run_kernel<std::vector<std::uint64_t>, 2>(reg, "vector", "merge_loop_dense", 8, fixture,
+                                                  [&] { return merge(halves, dense); });
+        run_kernel<std::vector<std::uint64_t>, 2>(reg, "vector", "merge_join_sparse", 8, fixture,
+                                                  [&] { return join(sparse, dense); });
+        run_kernel<std::vector<std::uint64_t>, 2>(reg, "vector", "merge_loop_sparse", 8, fixture,
+                                                  [&] { return merge(sparse, dense); });
+    }
+
+    // Windows of three neighbours: shifted zips step three iterators per row, adjacent steps one
+    void bench_adjacent(registry &reg) {
+        auto const n = elements_for<std::uint64_t>(reg.settings().elements);
+        std::vector<std::uint64_t> v(n);
+        std::iota(v.begin(), v.end(), 0);
+        std::list<std::uint64_t> l(v.begin(), v.end());
+
+        auto const shifted = [](auto const &input) {
+            using std::views::drop;
+            std::uint64_t sum = 0;
+            for (auto const &[a, b, c] : zip(input, input | drop(1), input | drop(2))) {
+                sum += a * c - b;
+            }
+            return sum;
+        };
+        auto const windows = [](auto const &input) {
+            std::uint64_t sum = 0;
+            for (auto const &[a, b, c] : adjacent<3>(input)) {
+                sum += a * c - b;
+            }
+            return sum;
+        };
+
+        columns_of<std::vector<std::uint64_t>> vectors{{}, n};
+        run_kernel<std::vector<std::uint64_t>, 1>(reg, "vector", "zip_drop", 8, vectors, [&] { return shifted(v); });
+        run_kernel<std::vector<std::uint64_t>, 1>(reg, "vector", "adjacent", 8, vectors, [&] { return windows(v); });
+        columns_of<std::list<std::uint64_t>> lists{{}, n};
+        run_kernel<std::list<std::uint64_t>, 1>(reg, "list", "zip_drop", 8, lists, [&] { return shifted(l); });
+        run_kernel<std::list<std::uint64_t>, 1>(reg, "list", "adjacent", 8, lists, [&] { return windows(l); });
+    }
+
+    // Cost of recording the iterations of a zip, whose statistics are updated once per loop
+    template <zip_config Config>
+    void bench_instrumentation(registry &reg, std::string_view variant) {
+        auto const n = elements_for<std::uint64_t>(reg.settings().elements);
+        std::vector<std::uint64_t> a(n, 1), b(n, 2);
+        columns_of<std::vector<std::uint64_t>> fixture{{}, n};
+        run_kernel<std::vector<std::uint64_t>, 2>(reg, "vector", variant, 8, fixture, [&] {
+            std::uint64_t sum = 0;
+            for (auto const &[x, y] : zip<Config>(a, b)) {
+                sum += x * y;
+            }
+            return sum;
+        });
+    }
+
+    zip_utils::bench::options parse(int argc, char **argv) {
+        zip_utils::bench::options result;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string_view const key = argv[i];
+            if (key == "--elements") {
+                result.elements = std::strtoull(argv[i + 1], nullptr, 10);
+            } else if (key == "--large-elements") {
+                result.large_elements = std::strtoull(argv[i + 1], nullptr, 10);
+            } else if (key == "--min-time-ms") {
+                result.min_time = std::chrono::milliseconds(std::strtoll(argv[i + 1], nullptr, 10));
+            } else if (key == "--filter") {
+                result.filter = argv[i + 1];
+            } else {
+                std::fprintf(stderr,
+                             "usage: %s [--elements N] [--large-elements N] [--min-time-ms MS] [--filter SUBSTRING]\n",
+                             argv[0]);
+                std::exit(EXIT_FAILURE);
+            }
+        }
+        return result;
+    }
+
+}  // namespace
+
+
+int main(int argc, char **argv) {
+    registry reg(parse(argc, argv));
+
+    bench_element_size<1>(reg);
+    bench_element_size<8>(reg);
+    bench_element_size<32>(reg);
+    bench_element_size<256>(reg);
+    bench_sets(reg);
+    bench_enumerate(reg);
+    bench_rvalues<zip_config::NONE>(reg, "rvalues_copy");
+    bench_rvalues<zip_config::MOVE_FROM_RVALUES>(reg, "rvalues_move");
+    bench_rvalues_index(reg);
+    bench_unzip(reg);
+    bench_merge_join(reg);
+    bench_adjacent(reg);
+    bench_instrumentation<zip_config::NONE>(reg, "not_instrumented");
+    bench_instrumentation<zip_config::INSTRUMENT>(reg, "instrumented");
+    bench_prefetch<zip_config::NONE>(reg, "zip");
+    bench_prefetch<zip_utils::configuration::prefetch<4>>(reg, "prefetch_4");
+    bench_prefetch<zip_config::PREFETCH>(reg, "prefetch_8");
+    bench_prefetch<zip_utils::configuration::prefetch<16>>(reg, "prefetch_16");
+
+    reg.print_json(stdout);
+    return 0;
+}
@@ -0,0 +1,129 @@
+# Compiles generated zips of 1-32 columns and reports the frontend time and memory of each as JSON.
+# Clang reports come from -ftime-trace, GCC reports from -ftime-report.
+#
+# Usage: cmake -DCOMPILER=<c++ compiler> -DINCLUDE=<include dir> -DWORK_DIR=<dir> -DOUTPUT=<json file>
+#              [-DCOLUMNS="1;2;4;8;16;32"] -P compile_bench.cmake
+
+cmake_minimum_required(VERSION 3.19)  # string(JSON)
+
+foreach (variable COMPILER INCLUDE WORK_DIR OUTPUT)
+    if (NOT DEFINED ${variable})
+        message(FATAL_ERROR "${variable} is not set")
+    endif ()
+endforeach ()
+if (NOT DEFINED COLUMNS)
+    set(COLUMNS 1 2 4 8 16 24 32)
+endif ()
+
+execute_process(COMMAND ${COMPILER} --version OUTPUT_VARIABLE version)
+if (version MATCHES "clang")
+    set(clang ON)
+else ()
+    set(clang OFF)
+endif ()
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+# A zip of `columns` vectors, iterated mutably and through const, with every element read by a binding
+function(generate columns path)
+    set(parameters)
+    set(arguments)
+    set(bindings)
+    set(sum)
+    math(EXPR last "${columns} - 1")
+    foreach (i RANGE ${last})
+        list(APPEND parameters "std::vector<int> &v${i}")
+        list(APPEND arguments "v${i}")
+        list(APPEND bindings "x${i}")
+        list(APPEND sum "x${i}")
+    endforeach ()
+    list(JOIN parameters ", " parameters)
+    list(JOIN arguments ", " arguments)
+    list(JOIN bindings ", " bindings)
+    list(JOIN sum " + " sum)
+
+    file(WRITE ${path} "#include <vector>\n#include \"zip_utils/zip_utils.hpp\"\n\n"
+        "using namespace zip_utils::views;\n\n"
+        "long kernel(${parameters}) {\n"
+        "    long sum = 0;\n"
+        "    auto z = zip(${arguments});\n"
+        "    for (auto &&[${bindings}] : z) {\n"
+        "        sum += ${sum};\n"
+        "    }\n"
+        "    for (auto const &[${bindings}] : std::as_const(z)) {\n"
+        "        sum += ${sum};\n"
+        "    }\n"
+        "    return sum + static_cast<long>(z.size()) + (z.end() - z.begin());\n"
+        "}\n")
+endfunction()
+
+# Milliseconds of a "<seconds>" field of -ftime-report
+function(seconds_to_ms seconds out)
+    string(REGEX MATCH "^([0-9]+)\\.([0-9][0-9])" _ "${seconds}")
+    math(EXPR ms "${CMAKE_MATCH_1} * 1000 + ${CMAKE_MATCH_2} * 10")
+    set(${out} ${ms} PARENT_SCOPE)
+endfunction()
+
+set(results)
+foreach (columns IN LISTS COLUMNS)
+    set(source ${WORK_DIR}/zip_${columns}.cpp)
+    set(object ${WORK_DIR}/zip_${columns}.o)
+    generate(${columns} ${source})
+
+    if (clang)
+        execute_process(
+            COMMAND ${COMPILER} -std=c++20 -O0 -ftime-trace -I${INCLUDE} -c ${source} -o ${object}
+            RESULT_VARIABLE status ERROR_VARIABLE errors)
+    else ()
+        execute_process(
+            COMMAND ${COMPILER} -std=c++20 -O0 -ftime-report -I${INCLUDE} -c ${source} -o ${object}
+            RESULT_VARIABLE status ERROR_VARIABLE errors)
+    endif ()
+    if (NOT status EQUAL 0)
+        message(FATAL_ERROR "Compilation of ${columns} columns failed:\n${errors}")
+    endif ()
+
+    if (clang)
+        file(READ ${WORK_DIR}/zip_${columns}.json trace)
+        string(JSON events_count LENGTH "${trace}" traceEvents)
+        math(EXPR last "${events_count} - 1")
+        set(frontend_us 0)
+        set(total_us 0)
+        foreach (i RANGE ${last})
+            string(JSON name ERROR_VARIABLE missing GET "${trace}" traceEvents ${i} name)
+            if (name STREQUAL "Total Frontend")
+                string(JSON frontend_us GET "${trace}" traceEvents ${i} dur)
+            elseif (name STREQUAL "Total ExecuteCompiler")
+                string(JSON total_us GET "${trace}" traceEvents ${i} dur)
+            endif ()
+        endforeach ()
+        math(EXPR frontend_ms "${frontend_us} / 1000")
+        math(EXPR total_ms "${total_us} / 1000")
+        # -ftime-trace does not record memory
+        set(memory_kb null)
+    else ()
+        # Parsing and template instantiation make up the frontend
+        set(frontend_ms 0)
+        foreach (phase "phase parsing" "phase lang. deferred")
+            string(REGEX MATCH " ${phase} *: *[0-9.]+ *\\([ 0-9]+%\\) *[0-9.]+ *\\([ 0-9]+%\\) *([0-9.]+)" _ "${errors}")
+            if (CMAKE_MATCH_1)
+                seconds_to_ms(${CMAKE_MATCH_1} ms)
+                math(EXPR frontend_ms "${frontend_ms} + ${ms}")
+            endif ()
+        endforeach ()
+        string(REGEX MATCH " TOTAL *: *[0-9.]+ *[0-9.]+ *([0-9.]+) *([0-9]+)([kM])" _ "${errors}")
+        seconds_to_ms(${CMAKE_MATCH_1} total_ms)
+        if (CMAKE_MATCH_3 STREQUAL "M")
+            math(EXPR memory_kb "${CMAKE_MATCH_2} * 1024")
+        else ()
+            set(memory_kb ${CMAKE_MATCH_2})
+        endif ()
+    endif ()
+
+    message(STATUS "${columns} columns: frontend ${frontend_ms} ms, total ${total_ms} ms, memory ${memory_kb} kB")
+    list(APPEND results "    {\"columns\": ${columns}, \"frontend_ms\": ${frontend_ms}, \"total_ms\": ${total_ms}, \"memory_kb\": ${memory_kb}}")
+endforeach ()
+
+list(JOIN results ",\n" results)
+file(WRITE ${OUTPUT} "{\n  \"compiler\": \"${COMPILER}\",\n  \"zips\": [\n${results}\n  ]\n}\n")
+message(STATUS "Results are written to ${OUTPUT}")
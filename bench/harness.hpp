@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Self-contained timing harness, results are printed as JSON
+namespace zip_utils::bench {
+
+    template <typename Value>
+    inline void do_not_optimize(Value const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile auto sink = value;
+        sink = value;
+#endif
+    }
+
+    struct options {
+        std::size_t elements = 1 << 16;
+        std::size_t large_elements = 1 << 21;  // node-based inputs well past the last level cache
+        std::chrono::milliseconds min_time{50};
+        std::string filter;
+    };
+
+    struct result {
+        std::string name;
+        std::string container;
+        std::string variant;
+        std::size_t columns;
+        std::size_t element_size;
+        std::size_t elements;
+        std::size_t iterations;
+        double ns_per_element;
+    };
+
+    class registry {
+       public:
+        explicit registry(options opts) : options_(std::move(opts)) {}
+
+        [[nodiscard]] options const &settings() const noexcept {
+            return options_;
+        }
+
+        // Runs `loop` (one pass over `elements` rows) until the minimal time passes, keeps the fastest pass
+        void run(result meta, std::function<void()> const &loop) {
+            if (!options_.filter.empty() && meta.name.find(options_.filter) == std::string::npos) {
+                return;
+            }
+
+            using clock = std::chrono::steady_clock;
+            loop();  // warm up
+
+            auto best = clock::duration::max();
+            auto total = clock::duration::zero();
+            std::size_t iterations = 0;
+            while (total < options_.min_time || iterations < 3) {
+                auto const start = clock::now();
+                loop();
+                auto const elapsed = clock::now() - start;
+                best = std::min(best, elapsed);
+                total += elapsed;
+                ++iterations;
+            }
+
+            meta.iterations = iterations;
+            meta.ns_per_element = std::chrono::duration<double, std::nano>(best).count() /
+                                  static_cast<double>(std::max<std::size_t>(meta.elements, 1));
+            results_.push_back(std::move(meta));
+        }
+
+        void print_json(std::FILE *out) const {
+            std::fprintf(out, "{\n  \"benchmarks\": [");
+            for (std::size_t i = 0; i < results_.size(); ++i) {
+                auto const &r = results_[i];
+                std::fprintf(out,
+                             "%s\n    {\"name\": \"%s\", \"container\": \"%s\", \"variant\": \"%s\", \"columns\": %zu, "
+                             "\"element_size\": %zu, \"elements\": %zu, \"iterations\": %zu, \"ns_per_element\": %.4f}",
+                             i == 0 ? "" : ",", r.name.c_str(), r.container.c_str(), r.variant.c_str(), r.columns,
+                             r.element_size, r.elements, r.iterations, r.ns_per_element);
+            }
+            std::fprintf(out, "\n  ]\n}\n");
+        }
+
+       private:
+        options options_;
+        std::vector<result> results_;
+    };
+
+}  // namespace zip_utils::bench
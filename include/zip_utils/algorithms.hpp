@@ -0,0 +1,128 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "detail/simd.hpp"
+#include "zip_utils.hpp"
+
+
+namespace zip_utils::detail::algorithms {
+
+    template <typename T>
+    concept arithmetic = std::is_arithmetic_v<T>;
+
+    template <typename Span>
+    concept arithmetic_span = arithmetic<std::remove_cv_t<typename Span::element_type>>;
+
+    // Zips of contiguous inputs and plain contiguous ranges, as a tuple of spans with the same size
+    template <typename Range>
+    constexpr auto columns(Range &range) {
+        if constexpr (requires { range.spans(); }) {
+            return range.spans();
+        } else {
+            return std::tuple{std::span(std::ranges::data(range), std::ranges::size(range))};
+        }
+    }
+
+    template <typename Range>
+    concept vectorizable = (requires(Range &range) { range.spans(); } ||
+                            (std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>)) &&
+                           requires(Range &range) {
+        []<typename... Spans>(std::tuple<Spans...>) requires(arithmetic_span<Spans> &&...) {}
+        (columns(range));
+    };
+
+    // Calls the function with the elements of a zip row, or with a plain element
+    template <typename Function, typename Row>
+    constexpr decltype(auto) invoke_row(Function &function, Row &&row) {
+        if constexpr (requires { row.template get<0>(); }) {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) -> decltype(auto) {
+                return std::invoke(function, std::as_const(row).template get<Indices>()...);
+            }
+            (std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Row>>>{});
+        } else {
+            return std::invoke(function, std::forward<Row>(row));
+        }
+    }
+
+    template <typename Out>
+    concept arithmetic_output = std::contiguous_iterator<Out> && arithmetic<std::iter_value_t<Out>>;
+
+    template <typename Reduce, typename T>
+    concept addition = std::same_as<Reduce, std::plus<>> || std::same_as<Reduce, std::plus<T>>;
+
+    inline constexpr auto identity = [](auto const &value) { return value; };
+    inline constexpr auto product = [](auto const &...values) { return (values * ...); };
+
+}  // namespace zip_utils::detail::algorithms
+
+
+namespace zip_utils::algorithms {
+
+    // Sums of contiguous arithmetic inputs run on SIMD kernels of the best instruction set of the CPU,
+    // so, like std::reduce, floating-point additions may be reassociated.
+
+    template <std::ranges::input_range Range, typename T, typename Reduce, typename Transform>
+    T transform_reduce(Range &&range, T init, Reduce reduce, Transform transform) {
+        using namespace detail::algorithms;
+        if constexpr (vectorizable<Range> && addition<Reduce, T> && arithmetic<T>) {
+            return std::apply(
+                [&](auto... spans) {
+                    auto const size = std::get<0>(std::tuple{spans...}).size();
+                    return detail::simd::transform_reduce(detail::simd::detected_instruction_set(), size, init,
+                                                          transform, spans.data()...);
+                },
+                columns(range));
+        } else {
+            for (auto &&row : range) {
+                init = std::invoke(reduce, std::move(init), invoke_row(transform, row));
+            }
+            return init;
+        }
+    }
+
+    template <std::ranges::input_range Range, typename T, typename Reduce = std::plus<>>
+    T reduce(Range &&range, T init, Reduce reduce = {}) {
+        return algorithms::transform_reduce(std::forward<Range>(range), std::move(init), std::move(reduce),
+                                            detail::algorithms::identity);
+    }
+
+    // Sum of the products of the columns of each row: a dot product of a zip of two inputs
+    template <std::ranges::input_range Range, typename T>
+    T inner_product(Range &&range, T init) {
+        return algorithms::transform_reduce(std::forward<Range>(range), std::move(init), std::plus<>{},
+                                            detail::algorithms::product);
+    }
+
+    // Writes function(columns...) of every row to `out`, returns the end of the written range
+    template <std::ranges::input_range Range, std::weakly_incrementable Out, typename Function>
+    Out transform(Range &&range, Out out, Function function) {
+        using namespace detail::algorithms;
+        if constexpr (vectorizable<Range> && arithmetic_output<Out>) {
+            return std::apply(
+                [&](auto... spans) {
+                    auto const size = std::get<0>(std::tuple{spans...}).size();
+                    detail::simd::transform(detail::simd::detected_instruction_set(), size, std::to_address(out),
+                                            function, spans.data()...);
+                    return out + static_cast<std::iter_difference_t<Out>>(size);
+                },
+                columns(range));
+        } else {
+            for (auto &&row : range) {
+                *out = invoke_row(function, row);
+                ++out;
+            }
+            return out;
+        }
+    }
+
+}  // namespace zip_utils::algorithms
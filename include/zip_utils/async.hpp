@@ -0,0 +1,556 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "zip_utils.hpp"
+
+
+namespace zip_utils::detail::async {
+
+    // One-shot completion, awaited either by a coroutine or by a blocked thread
+    class event {
+       public:
+        void reset() noexcept {
+            std::lock_guard lock(mutex_);
+            arrived_ = false;
+            waiter_ = {};
+        }
+
+        // Returns the coroutine to resume: the registered waiter, if any
+        std::coroutine_handle<> complete() noexcept {
+            std::lock_guard lock(mutex_);
+            arrived_ = true;
+            ready_.notify_all();
+            return waiter_ ? std::exchange(waiter_, {}) : std::noop_coroutine();
+        }
+
+        [[nodiscard]] bool ready() noexcept {
+            std::lock_guard lock(mutex_);
+            return arrived_;
+        }
+
+        // Registers the waiter unless the event already happened, returns whether it was registered
+        bool suspend(std::coroutine_handle<> waiter) noexcept {
+            std::lock_guard lock(mutex_);
+            if (arrived_) {
+                return false;
+            }
+            waiter_ = waiter;
+            return true;
+        }
+
+        void wait() {
+            std::unique_lock lock(mutex_);
+            ready_.wait(lock, [&] { return arrived_; });
+        }
+
+        auto operator co_await() noexcept {
+            struct awaiter {
+                event &self;
+
+                bool await_ready() noexcept {
+                    return self.ready();
+                }
+
+                bool await_suspend(std::coroutine_handle<> waiter) noexcept {
+                    return self.suspend(waiter);
+                }
+
+                void await_resume() noexcept {}
+            };
+            return awaiter{*this};
+        }
+
+       private:
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        bool arrived_ = false;
+        std::coroutine_handle<> waiter_;
+    };
+
+
+    template <typename T>
+    struct task_result {
+        std::optional<T> value;
+
+        template <typename U>
+        void return_value(U &&result) {
+            value.emplace(std::forward<U>(result));
+        }
+
+        T take() {
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct task_result<void> {
+        void return_void() noexcept {}
+        void take() noexcept {}
+    };
+
+}  // namespace zip_utils::detail::async
+
+
+namespace zip_utils::async {
+
+    // A local executor: a few threads resuming posted coroutines in order, no external runtime.
+    // It must outlive everything running on it.
+    class executor {
+       public:
+        explicit executor(std::size_t threads = 2) {
+            threads = std::max<std::size_t>(threads, 1);
+            workers_.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers_.emplace_back([this] { worker_main(); });
+            }
+        }
+
+        executor(executor const &) = delete;
+        executor &operator=(executor const &) = delete;
+
+        // Runs what is already posted, then stops
+        ~executor() {
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto &worker : workers_) {
+                worker.join();
+            }
+        }
+
+        void post(std::coroutine_handle<> coroutine) {
+            {
+                std::lock_guard lock(mutex_);
+                queue_.push_back(coroutine);
+            }
+            wake_.notify_one();
+        }
+
+        // `co_await ex.schedule()` continues the coroutine on a thread of the executor
+        auto schedule() noexcept {
+            struct awaiter {
+                executor &self;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> coroutine) {
+                    self.post(coroutine);
+                }
+
+                void await_resume() const noexcept {}
+            };
+            return awaiter{*this};
+        }
+
+       private:
+        void worker_main() {
+            std::unique_lock lock(mutex_);
+            while (true) {
+                wake_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                auto coroutine = queue_.front();
+                queue_.pop_front();
+                lock.unlock();
+                coroutine.resume();
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::deque<std::coroutine_handle<>> queue_;
+        bool stop_ = false;
+        std::vector<std::thread> workers_;
+    };
+
+
+    // A lazy coroutine with a single awaiter, started by `co_await` or `sync_wait`
+    template <typename T = void>
+    class [[nodiscard]] task {
+       public:
+        struct promise_type : detail::async::task_result<T> {
+            std::coroutine_handle<> continuation;
+            detail::async::event *finished = nullptr;
+            std::exception_ptr error;
+
+            task get_return_object() noexcept {
+                return task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            auto final_suspend() const noexcept {
+                struct awaiter {
+                    bool await_ready() const noexcept {
+                        return false;
+                    }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept {
+                        auto &promise = self.promise();
+                        if (promise.continuation) {
+                            return promise.continuation;
+                        }
+                        return promise.finished->complete();
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+                return awaiter{};
+            }
+
+            void unhandled_exception() noexcept {
+                error = std::current_exception();
+            }
+
+            T result() {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                return this->take();
+            }
+        };
+
+        task(task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+        task &operator=(task &&other) noexcept {
+            std::swap(handle_, other.handle_);
+            return *this;
+        }
+
+        ~task() {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        auto operator co_await() noexcept {
+            struct awaiter {
+                std::coroutine_handle<promise_type> self;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+                    self.promise().continuation = continuation;
+                    return self;
+                }
+
+                T await_resume() {
+                    return self.promise().result();
+                }
+            };
+            return awaiter{handle_};
+        }
+
+       private:
+        template <typename U>
+        friend U sync_wait(task<U> work);
+
+        explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+
+    // Runs the task, starting on the calling thread, and blocks until it finishes
+    template <typename T>
+    T sync_wait(task<T> work) {
+        detail::async::event finished;
+        work.handle_.promise().finished = &finished;
+        work.handle_.resume();
+        finished.wait();
+        return work.handle_.promise().result();
+    }
+
+
+    // A producer of chunks: `co_yield` hands over one chunk, the body may `co_await` anything in between.
+    // Each next chunk is produced on an executor while the previous one is consumed.
+    template <typename Chunk>
+    class generator {
+       public:
+        struct promise_type {
+            std::optional<Chunk> chunk;
+            detail::async::event *produced = nullptr;
+            std::exception_ptr error;
+            // Set by the handover and by a consumer leaving mid-step, whichever comes second owns the frame
+            std::atomic_flag parted;
+
+            struct handover {
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept {
+                    auto &promise = self.promise();
+                    if (promise.parted.test_and_set()) {
+                        self.destroy();  // nobody takes the chunk any more
+                        return std::noop_coroutine();
+                    }
+                    return promise.produced->complete();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            generator get_return_object() noexcept {
+                return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            handover final_suspend() const noexcept {
+                return {};
+            }
+
+            template <std::convertible_to<Chunk> Value>
+            handover yield_value(Value &&value) {
+                chunk.emplace(std::forward<Value>(value));
+                return {};
+            }
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() noexcept {
+                error = std::current_exception();
+            }
+        };
+
+        generator(generator &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+        generator &operator=(generator &&other) noexcept {
+            std::swap(handle_, other.handle_);
+            return *this;
+        }
+
+        ~generator() {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        [[nodiscard]] std::coroutine_handle<promise_type> handle() const noexcept {
+            return handle_;
+        }
+
+        // Gives up the frame, which is then destroyed by whoever took it
+        std::coroutine_handle<promise_type> release() noexcept {
+            return std::exchange(handle_, {});
+        }
+
+       private:
+        explicit generator(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+}  // namespace zip_utils::async
+
+
+namespace zip_utils::detail::async {
+
+    template <typename Chunk>
+    concept chunk = std::ranges::contiguous_range<Chunk> && std::ranges::sized_range<Chunk> &&
+                    std::movable<Chunk> && std::default_initializable<Chunk>;
+
+    template <chunk Chunk>
+    using chunk_span = std::span<std::remove_reference_t<std::ranges::range_reference_t<Chunk &>>>;
+
+    // A column of an async zip: the chunk being consumed, while the generator produces the next one
+    template <chunk Chunk>
+    class column {
+       public:
+        explicit column(zip_utils::async::generator<Chunk> source) noexcept : source_(std::move(source)) {}
+
+        column(column const &) = delete;
+        column &operator=(column const &) = delete;
+
+        // A generator frame must not be destroyed while it runs: a producer still in its step destroys its own
+        // frame at the handover, one past the handover only has to finish completing the event
+        ~column() {
+            if (!fetching_) {
+                return;
+            }
+            if (!source_.handle().promise().parted.test_and_set()) {
+                source_.release();
+                return;
+            }
+            produced_.wait();
+        }
+
+        void start(zip_utils::async::executor &executor) {
+            executor_ = &executor;
+            fetch();
+        }
+
+        // Makes sure the current chunk has rows, waiting for the produced ones; false at the end of the source
+        zip_utils::async::task<bool> ensure() {
+            while (offset_ == std::ranges::size(current_)) {
+                if (!fetching_) {
+                    co_return false;
+                }
+                co_await produced_;
+                take();
+            }
+            co_return true;
+        }
+
+        [[nodiscard]] std::size_t remaining() const noexcept {
+            return std::ranges::size(current_) - offset_;
+        }
+
+        chunk_span<Chunk> rows(std::size_t count) noexcept {
+            auto span = chunk_span<Chunk>(std::ranges::data(current_) + offset_, count);
+            offset_ += count;
+            return span;
+        }
+
+       private:
+        void fetch() {
+            auto &promise = source_.handle().promise();
+            promise.chunk.reset();
+            promise.produced = &produced_;
+            promise.parted.clear();
+            produced_.reset();
+            fetching_ = true;
+            executor_->post(source_.handle());
+        }
+
+        void take() {
+            fetching_ = false;
+            auto &promise = source_.handle().promise();
+            if (promise.error) {
+                std::rethrow_exception(std::exchange(promise.error, nullptr));
+            }
+            if (!promise.chunk) {
+                return;  // the generator finished
+            }
+            current_ = std::move(*promise.chunk);
+            offset_ = 0;
+            fetch();
+        }
+
+        zip_utils::async::generator<Chunk> source_;
+        zip_utils::async::executor *executor_ = nullptr;
+        event produced_;
+        bool fetching_ = false;
+        Chunk current_{};
+        std::size_t offset_ = 0;
+    };
+
+}  // namespace zip_utils::detail::async
+
+
+namespace zip_utils::async {
+
+    // Zips chunk generators: the next chunk of every column is produced concurrently on the executor
+    // while the current ones are consumed. Rows (and chunks) stay valid until the next call.
+    // Reading is either row by row with `next` or chunk by chunk with `next_chunk`, not both.
+    template <detail::async::chunk... Chunks>
+    class zip_stream {
+       public:
+        using chunk_type = decltype(views::zip(std::declval<detail::async::chunk_span<Chunks>>()...));
+        using row_type = std::remove_cvref_t<std::ranges::range_reference_t<chunk_type>>;
+
+        explicit zip_stream(executor &executor, generator<Chunks>... sources) : columns_(std::move(sources)...) {
+            std::apply([&](auto &...columns) { (columns.start(executor), ...); }, columns_);
+        }
+
+        zip_stream(zip_stream const &) = delete;
+        zip_stream &operator=(zip_stream const &) = delete;
+
+        // The next rows available in every column, as a zip of spans; empty at the end
+        task<std::optional<chunk_type>> next_chunk() {
+            bool const more = co_await ensure(std::index_sequence_for<Chunks...>{});
+            if (!more) {
+                co_return std::nullopt;
+            }
+            co_return take_rows();
+        }
+
+        // The next row, as a tuple of references; empty at the end
+        auto next() {
+            struct awaiter {
+                zip_stream &self;
+                std::optional<task<bool>> refill;
+
+                bool await_ready() const noexcept {
+                    return self.cursor_ != self.last_;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) {
+                    refill.emplace(self.ensure(std::index_sequence_for<Chunks...>{}));
+                    return refill->operator co_await().await_suspend(continuation);
+                }
+
+                std::optional<row_type> await_resume() {
+                    if (refill) {
+                        if (!refill->operator co_await().await_resume()) {
+                            return std::nullopt;
+                        }
+                        self.rows_.emplace(self.take_rows());
+                        self.cursor_ = std::ranges::begin(*self.rows_);
+                        self.last_ = std::ranges::end(*self.rows_);
+                    }
+                    std::optional<row_type> row(*self.cursor_);
+                    ++self.cursor_;
+                    return row;
+                }
+            };
+            return awaiter{*this, std::nullopt};
+        }
+
+       private:
+        template <std::size_t... Indices>
+        task<bool> ensure(std::index_sequence<Indices...>) {
+            co_return (co_await std::get<Indices>(columns_).ensure() && ...);
+        }
+
+        chunk_type take_rows() {
+            return std::apply(
+                [](auto &...columns) {
+                    auto const count = std::min({columns.remaining()...});
+                    return views::zip(columns.rows(count)...);
+                },
+                columns_);
+        }
+
+        std::tuple<detail::async::column<Chunks>...> columns_;
+        std::optional<chunk_type> rows_;
+        std::ranges::iterator_t<chunk_type> cursor_{};
+        std::ranges::iterator_t<chunk_type> last_{};
+    };
+
+
+    template <typename... Chunks>
+    zip_stream<Chunks...> zip(executor &executor, generator<Chunks>... sources) {
+        return zip_stream<Chunks...>(executor, std::move(sources)...);
+    }
+
+}  // namespace zip_utils::async
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "configuration.hpp"
+#include "impl.hpp"
+#include "utils.hpp"
+
+
+namespace zip_utils::detail::adjacent {
+
+    // Windows of N consecutive elements are zip values of N iterators into the same range, their rows are
+    // tuples of N element references
+    template <typename Iterator, typename Indices>
+    struct window;
+
+    template <typename Iterator, std::size_t... Indices>
+    struct window<Iterator, std::index_sequence<Indices...>> {
+        template <std::size_t>
+        using component = Iterator;
+
+        template <std::size_t>
+        static constexpr bool by_rvalue = false;
+
+        using positions = impl::zip_value<configuration::zip_config::NONE, utils::bool_mask<by_rvalue<Indices>...>,
+                                          component<Indices>...>;
+        using value = impl::zip_row<std::iter_value_t<component<Indices>>...>;
+        using reference = impl::zip_row<std::iter_reference_t<component<Indices>>...>;
+    };
+
+    template <typename Iterator, std::size_t N>
+    using positions_t = typename window<Iterator, std::make_index_sequence<N>>::positions;
+
+    template <typename Iterator, std::size_t N>
+    using value_t = typename window<Iterator, std::make_index_sequence<N>>::value;
+
+    template <typename Iterator, std::size_t N>
+    using reference_t = typename window<Iterator, std::make_index_sequence<N>>::reference;
+
+
+    // Windows of a random access range: a single iterator, the components of a row are at offsets 0 ... N - 1
+    template <std::random_access_iterator Iterator, std::size_t N>
+    class shifted_iterator {
+        using base_iterator = Iterator;
+
+       public:
+        using value_type = value_t<base_iterator, N>;
+        using reference = reference_t<base_iterator, N>;
+        using difference_type = std::iter_difference_t<base_iterator>;
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+
+        constexpr shifted_iterator() = default;
+
+        explicit constexpr shifted_iterator(base_iterator first) noexcept(
+            std::is_nothrow_move_constructible_v<base_iterator>)
+            : first_(std::move(first)) {}
+
+        // Rows are returned by value as tuples of element references, like the rows of a zip
+        constexpr reference operator*() const {
+            return row_at(first_);
+        }
+
+        constexpr reference operator[](difference_type n) const {
+            return row_at(first_ + n);
+        }
+
+        constexpr shifted_iterator &operator++() noexcept(noexcept(++first_)) {
+            ++first_;
+            return *this;
+        }
+
+        constexpr shifted_iterator operator++(int) noexcept(noexcept(++first_)) {
+            auto copy = *this;
+            ++first_;
+            return copy;
+        }
+
+        constexpr shifted_iterator &operator--() noexcept(noexcept(--first_)) {
+            --first_;
+            return *this;
+        }
+
+        constexpr shifted_iterator operator--(int) noexcept(noexcept(--first_)) {
+            auto copy = *this;
+            --first_;
+            return copy;
+        }
+
+        constexpr shifted_iterator &operator+=(difference_type n) noexcept(noexcept(first_ += n)) {
+            first_ += n;
+            return *this;
+        }
+
+        constexpr shifted_iterator &operator-=(difference_type n) noexcept(noexcept(first_ -= n)) {
+            first_ -= n;
+            return *this;
+        }
+
+        friend constexpr shifted_iterator operator+(shifted_iterator it, difference_type n) noexcept(noexcept(it += n)) {
+            return it += n;
+        }
+
+        friend constexpr shifted_iterator operator+(difference_type n, shifted_iterator it) noexcept(noexcept(it += n)) {
+            return it += n;
+        }
+
+        friend constexpr shifted_iterator operator-(shifted_iterator it, difference_type n) noexcept(noexcept(it -= n)) {
+            return it -= n;
+        }
+
+        friend constexpr difference_type operator-(shifted_iterator const &lhs, shifted_iterator const &rhs) noexcept(
+            noexcept(lhs.first_ - rhs.first_)) {
+            return lhs.first_ - rhs.first_;
+        }
+
+        constexpr bool operator==(shifted_iterator const &other) const noexcept(noexcept(first_ == other.first_)) {
+            return first_ == other.first_;
+        }
+
+        constexpr std::strong_ordering operator<=>(shifted_iterator const &other) const
+            noexcept(noexcept(first_ - other.first_)) {
+            return first_ - other.first_ <=> 0;
+        }
+
+       private:
+        static constexpr reference row_at(base_iterator const &first) {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                return reference(first[static_cast<difference_type>(Indices)]...);
+            }
+            (std::make_index_sequence<N>{});
+        }
+
+        base_iterator first_{};
+    };
+
+
+    // Windows of a forward range: the iterator keeps the last N positions, like a zip iterator of N inputs.
+    // A step advances only the newest position and shifts the others down.
+    template <std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel, std::size_t N>
+    class window_iterator : private positions_t<Iterator, N> {
+        using base = positions_t<Iterator, N>;
+
+        // Ranges shorter than a window leave the newest positions at the end
+        static constexpr base first_window(Iterator first, Sentinel const &last) {
+            std::array<Iterator, N> positions{std::move(first)};
+            for (std::size_t i = 1; i < N; ++i) {
+                positions[i] = std::ranges::next(positions[i - 1], 1, last);
+            }
+            return std::apply([](auto &...window) { return base(std::move(window)...); }, positions);
+        }
+
+       public:
+        using value_type = value_t<Iterator, N>;
+        using reference = reference_t<Iterator, N>;
+        using difference_type = std::iter_difference_t<Iterator>;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr window_iterator() = default;
+
+        constexpr window_iterator(Iterator first, Sentinel last)
+            : base(first_window(std::move(first), last)), end_(std::move(last)) {}
+
+        constexpr reference operator*() const noexcept(noexcept(this->row())) {
+            return this->row();
+        }
+
+        constexpr window_iterator &operator++() {
+            static_cast<base &>(*this) = this->read_iterators([](auto const &...window) {
+                std::array<Iterator, N> const positions{window...};
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return base(positions[Indices + 1]..., std::ranges::next(positions[N - 1]));
+                }
+                (std::make_index_sequence<N - 1>{});
+            });
+            return *this;
+        }
+
+        constexpr window_iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        constexpr bool operator==(window_iterator const &other) const {
+            return oldest() == other.oldest();
+        }
+
+        constexpr bool operator==(std::default_sentinel_t) const {
+            return newest() == end_;
+        }
+
+       private:
+        constexpr Iterator oldest() const {
+            return this->read_iterators([](auto const &first, auto const &...) { return first; });
+        }
+
+        constexpr Iterator newest() const {
+            return this->read_iterators([](auto const &...window) { return std::array<Iterator, N>{window...}[N - 1]; });
+        }
+
+        [[no_unique_address]] Sentinel end_{};
+    };
+
+
+    template <std::ranges::forward_range Range, std::size_t N>
+    class adjacent_view : public std::ranges::view_interface<adjacent_view<Range, N>> {
+        // A const view reads its input as a const range, like a zip
+        template <typename Self>
+        using range_t = std::conditional_t<std::is_const_v<Self>, std::remove_reference_t<Range> const,
+                                           std::remove_reference_t<Range>>;
+
+        // The last window is found from the size, or there is none: no iterator steps past the end
+        template <typename Input>
+        static constexpr bool shifted =
+            std::ranges::random_access_range<Input> && (std::ranges::sized_range<Input> || utils::unbounded_range<Input>);
+
+       public:
+        template <typename Input>
+        requires(!std::same_as<std::remove_cvref_t<Input>, adjacent_view>)
+        explicit constexpr adjacent_view(Input &&input) noexcept(
+            std::is_nothrow_constructible_v<utils::stored_input<Range>, Input &&>)
+            : input_(std::forward<Input>(input)) {}
+
+        constexpr auto begin() {
+            return begin_of(*this);
+        }
+
+        constexpr auto begin() const requires std::ranges::forward_range<range_t<adjacent_view const>> {
+            return begin_of(*this);
+        }
+
+        constexpr auto end() {
+            return end_of(*this);
+        }
+
+        constexpr auto end() const requires std::ranges::forward_range<range_t<adjacent_view const>> {
+            return end_of(*this);
+        }
+
+        constexpr std::size_t size() requires std::ranges::sized_range<range_t<adjacent_view>> {
+            return size_of(*this);
+        }
+
+        constexpr std::size_t size() const requires std::ranges::sized_range<range_t<adjacent_view const>> {
+            return size_of(*this);
+        }
+
+       private:
+        template <typename Self>
+        static constexpr auto &range(Self &self) noexcept {
+            return static_cast<range_t<Self> &>(self.input_.get());
+        }
+
+        template <typename Self>
+        static constexpr auto begin_of(Self &self) {
+            if constexpr (shifted<range_t<Self>>) {
+                return shifted_iterator<std::ranges::iterator_t<range_t<Self>>, N>(std::ranges::begin(range(self)));
+            } else {
+                return window_iterator<std::ranges::iterator_t<range_t<Self>>, std::ranges::sentinel_t<range_t<Self>>, N>(
+                    std::ranges::begin(range(self)), std::ranges::end(range(self)));
+            }
+        }
+
+        template <typename Self>
+        static constexpr auto end_of(Self &self) {
+            using input = range_t<Self>;
+            if constexpr (shifted<input> && std::ranges::sized_range<input>) {
+                return shifted_iterator<std::ranges::iterator_t<input>, N>(std::ranges::begin(range(self)) +
+                                                  static_cast<std::ranges::range_difference_t<input>>(size_of(self)));
+            } else if constexpr (shifted<input>) {
+                return std::unreachable_sentinel;
+            } else {
+                return std::default_sentinel;
+            }
+        }
+
+        template <typename Self>
+        static constexpr std::size_t size_of(Self &self) {
+            auto const size = static_cast<std::size_t>(std::ranges::size(range(self)));
+            return size >= N ? size - (N - 1) : 0;
+        }
+
+        utils::stored_input<Range> input_;
+    };
+
+
+    // Calls the function with the N elements of a row
+    template <std::size_t N, typename Function>
+    struct row_function {
+        template <typename Row>
+        constexpr decltype(auto) operator()(Row const &row) const {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>)->decltype(auto) {
+                return std::invoke(function, row.template get<Indices>()...);
+            }
+            (std::make_index_sequence<N>{});
+        }
+
+        [[no_unique_address]] Function function;
+    };
+
+}  // namespace zip_utils::detail::adjacent
+
+
+namespace std::ranges {
+
+    // Windows point into the input only
+    template <typename Range, std::size_t N>
+    inline constexpr bool enable_borrowed_range<zip_utils::detail::adjacent::adjacent_view<Range, N>> =
+        is_lvalue_reference_v<Range> || enable_borrowed_range<remove_cvref_t<Range>>;
+
+}  // namespace std::ranges
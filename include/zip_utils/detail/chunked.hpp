@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace zip_utils::detail::chunked {
+
+    // Contiguous inputs are split as spans: a tuple of them for a zip, a single one for a plain range
+    template <typename Range>
+    concept span_splittable = requires(Range &range) { range.spans(); } ||
+                              (std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>);
+
+    template <typename Range>
+    constexpr auto as_spans(Range &range) {
+        if constexpr (requires { range.spans(); }) {
+            return range.spans();
+        } else {
+            return std::span(std::ranges::data(range), std::ranges::size(range));
+        }
+    }
+
+    template <typename Spans>
+    constexpr std::size_t rows(Spans const &spans) noexcept {
+        if constexpr (requires { spans.size(); }) {
+            return spans.size();
+        } else {
+            return std::get<0>(spans).size();
+        }
+    }
+
+    template <typename Spans>
+    constexpr Spans first(Spans const &spans, std::size_t count) noexcept {
+        if constexpr (requires { spans.size(); }) {
+            return spans.first(count);
+        } else {
+            return std::apply([&](auto const &...columns) { return Spans{columns.first(count)...}; }, spans);
+        }
+    }
+
+    template <typename Spans>
+    constexpr Spans drop(Spans const &spans, std::size_t count) noexcept {
+        if constexpr (requires { spans.size(); }) {
+            return spans.subspan(count);
+        } else {
+            return std::apply([&](auto const &...columns) { return Spans{columns.subspan(count)...}; }, spans);
+        }
+    }
+
+
+    template <std::size_t Extent>
+    class chunk_size {
+       public:
+        explicit constexpr chunk_size(std::size_t) noexcept {}
+
+        [[nodiscard]] constexpr std::size_t get() const noexcept {
+            return Extent;
+        }
+    };
+
+    template <>
+    class chunk_size<std::dynamic_extent> {
+       public:
+        explicit constexpr chunk_size(std::size_t size) noexcept : size_(size) {}
+
+        [[nodiscard]] constexpr std::size_t get() const noexcept {
+            return size_;
+        }
+
+       private:
+        std::size_t size_;
+    };
+
+
+    template <typename Spans, std::size_t Extent>
+    class span_chunk_iterator {
+       public:
+        using value_type = Spans;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr span_chunk_iterator() = default;
+
+        constexpr span_chunk_iterator(Spans spans, chunk_size<Extent> size) noexcept
+            : rest_(std::move(spans)), size_(size) {}
+
+        constexpr value_type operator*() const noexcept {
+            return first(rest_, std::min(size_.get(), rows(rest_)));
+        }
+
+        constexpr span_chunk_iterator &operator++() noexcept {
+            rest_ = drop(rest_, std::min(size_.get(), rows(rest_)));
+            return *this;
+        }
+
+        constexpr span_chunk_iterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        constexpr bool operator==(span_chunk_iterator const &other) const noexcept {
+            return rows(rest_) == rows(other.rest_);
+        }
+
+        constexpr bool operator==(std::default_sentinel_t) const noexcept {
+            return rows(rest_) == 0;
+        }
+
+       private:
+        Spans rest_{};
+        [[no_unique_address]] chunk_size<Extent> size_{0};
+    };
+
+
+    // Chunks of other ranges are subranges, found by advancing at most the chunk size towards the end
+    template <typename Iterator, typename Sentinel, std::size_t Extent>
+    class subrange_chunk_iterator {
+       public:
+        using value_type = std::ranges::subrange<Iterator>;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr subrange_chunk_iterator() = default;
+
+        constexpr subrange_chunk_iterator(Iterator first, Sentinel last, chunk_size<Extent> size)
+            : current_(first), next_(first), end_(std::move(last)), size_(size) {
+            advance();
+        }
+
+        constexpr value_type operator*() const {
+            return {current_, next_};
+        }
+
+        constexpr subrange_chunk_iterator &operator++() {
+            current_ = next_;
+            advance();
+            return *this;
+        }
+
+        constexpr subrange_chunk_iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        constexpr bool operator==(subrange_chunk_iterator const &other) const {
+            return current_ == other.current_;
+        }
+
+        constexpr bool operator==(std::default_sentinel_t) const {
+            return current_ == end_;
+        }
+
+       private:
+        constexpr void advance() {
+            std::ranges::advance(next_, static_cast<std::iter_difference_t<Iterator>>(size_.get()), end_);
+        }
+
+        Iterator current_{};
+        Iterator next_{};
+        Sentinel end_{};
+        [[no_unique_address]] chunk_size<Extent> size_{0};
+    };
+
+
+    template <std::ranges::forward_range Range, std::size_t Extent>
+    class chunked_view {
+       public:
+        // Empty chunks would never advance: `size` must be positive
+        template <typename Input>
+        constexpr chunked_view(Input &&range, std::size_t size) noexcept(
+            std::is_nothrow_constructible_v<Range, Input &&>)
+            : range_(std::forward<Input>(range)), size_(size) {
+            assert(size_.get() > 0 && "Chunks can not be empty.");
+        }
+
+        constexpr auto begin() {
+            if constexpr (span_splittable<Range>) {
+                return span_chunk_iterator<decltype(as_spans(range_)), Extent>(as_spans(range_), size_);
+            } else {
+                return subrange_chunk_iterator<std::ranges::iterator_t<Range>, std::ranges::sentinel_t<Range>, Extent>(
+                    std::ranges::begin(range_), std::ranges::end(range_), size_);
+            }
+        }
+
+        constexpr std::default_sentinel_t end() const noexcept {
+            return std::default_sentinel;
+        }
+
+        constexpr std::size_t size() requires std::ranges::sized_range<Range> {
+            auto const rows = static_cast<std::size_t>(std::ranges::size(range_));
+            return (rows + size_.get() - 1) / size_.get();
+        }
+
+       private:
+        Range range_;
+        [[no_unique_address]] chunk_size<Extent> size_;
+    };
+
+}  // namespace zip_utils::detail::chunked
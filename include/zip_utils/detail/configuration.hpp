@@ -7,10 +7,36 @@ namespace zip_utils::configuration {
 
     enum class zip_config : std::size_t {
         NONE = 0b0,
-        MOVE_FROM_RVALUES = 0b1,  // Elements of rvalue containers will be moved
+        MOVE_FROM_RVALUES = 0b1,          // Elements of rvalue containers will be moved
+        BASIC_EXCEPTION_GUARANTEE = 0b10,  // A throwing step leaves the iterator valid, but partially moved
+        UNDO_ON_EXCEPTION = 0b100,         // A throwing step is rolled back by the inverse steps of moved components
+        PREFETCH = 0b1000,                 // Node-based inputs of sized zips are prefetched ahead, see `prefetch`
+        INSTRUMENT = 0b10000,              // Iterations are recorded per call site, see `instrumentation::registry`
+        EQUAL_LENGTHS = 0b100000,          // Inputs have the same length, only the first bounded one is checked
+                                           // for the end. Debug builds assert it.
     };
 
 
+    // Rows of a merge join: only matching keys, or every left row with its matches, if any
+    enum class join_kind {
+        INNER,
+        LEFT_OUTER,
+    };
+
+
+    inline constexpr std::size_t default_prefetch_distance = 8;
+
+    // Rows to prefetch ahead of sized zips of node-based inputs, stored above the flag bits
+    template <std::size_t Distance>
+    requires(Distance > 0 && Distance < (std::size_t{1} << 16)) inline constexpr zip_config prefetch =
+        static_cast<zip_config>(static_cast<std::size_t>(zip_config::PREFETCH) | Distance << 16);
+
+    template <zip_config Config>
+    inline constexpr std::size_t prefetch_distance =
+        (static_cast<std::size_t>(Config) >> 16 & 0xFFFF) == 0 ? default_prefetch_distance
+                                                                : static_cast<std::size_t>(Config) >> 16 & 0xFFFF;
+
+
     template <zip_config Lhs, zip_config Rhs>
     static constexpr bool contains = (static_cast<std::size_t>(Lhs) & static_cast<std::size_t>(Rhs)) != 0;
 
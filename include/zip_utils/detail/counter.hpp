@@ -1,71 +1,166 @@
 #pragma once
 
+#include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <ranges>
+#include <type_traits>
 
 #include "utils.hpp"
 
 
 namespace zip_utils::detail::counter {
 
+    // Counts from `start` by `step`, indices wrap around in the index type
+    template <std::integral Index = std::size_t>
     class counting_iterator {
+        using signed_index = std::make_signed_t<Index>;
+
        public:
-        constexpr counting_iterator() : index_(0){};
+        using value_type = Index;
+        using reference = Index;
+        using difference_type = std::int64_t;
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
 
-        using value_type = const std::size_t;
-        using reference = value_type &;
-        using iterator_category = std::forward_iterator_tag;
-        using difference_type = int;
+        constexpr counting_iterator() = default;
 
+        constexpr counting_iterator(Index start, Index step) noexcept : index_(start), step_(step) {}
 
         constexpr reference operator*() const noexcept {
             return index_;
         }
 
+        constexpr reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
 
         constexpr counting_iterator &operator++() noexcept {
-            ++index_;
+            index_ = static_cast<Index>(index_ + step_);
             return *this;
         }
 
-
         constexpr counting_iterator operator++(int) &noexcept {
             auto copy = *this;
             ++*this;
             return copy;
         }
 
+        constexpr counting_iterator &operator--() noexcept {
+            index_ = static_cast<Index>(index_ - step_);
+            return *this;
+        }
+
+        constexpr counting_iterator operator--(int) &noexcept {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        constexpr counting_iterator &operator+=(difference_type n) noexcept {
+            index_ = static_cast<Index>(index_ + static_cast<Index>(n) * step_);
+            return *this;
+        }
 
-        constexpr bool operator==(counting_iterator const &) const noexcept {
-            return false;
+        constexpr counting_iterator &operator-=(difference_type n) noexcept {
+            index_ = static_cast<Index>(index_ - static_cast<Index>(n) * step_);
+            return *this;
         }
 
+        friend constexpr counting_iterator operator+(counting_iterator it, difference_type n) noexcept {
+            return it += n;
+        }
 
-        constexpr bool operator!=(counting_iterator const &) const noexcept {
-            return true;
+        friend constexpr counting_iterator operator+(difference_type n, counting_iterator it) noexcept {
+            return it += n;
         }
 
+        friend constexpr counting_iterator operator-(counting_iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        // Iterators of one counter are a whole number of steps apart
+        friend constexpr difference_type operator-(counting_iterator const &lhs, counting_iterator const &rhs) noexcept {
+            auto const distance = static_cast<signed_index>(static_cast<Index>(lhs.index_ - rhs.index_));
+            if (rhs.step_ == 1) {
+                return static_cast<difference_type>(distance);
+            }
+            return static_cast<difference_type>(distance) / static_cast<difference_type>(rhs.step_);
+        }
+
+        constexpr bool operator==(counting_iterator const &other) const noexcept {
+            return index_ == other.index_;
+        }
+
+        constexpr std::strong_ordering operator<=>(counting_iterator const &other) const noexcept {
+            return (*this - other) <=> 0;
+        }
 
        private:
-        std::size_t index_;
+        Index index_ = 0;
+        Index step_ = 1;
     };
 
 
-    inline constexpr counting_iterator end_count{};
+    // Unbounded counters end with std::unreachable_sentinel, so zips with them keep the size of the other inputs
+    template <std::integral Index = std::size_t, bool Bounded = false>
+    class counter : public std::ranges::view_interface<counter<Index, Bounded>> {
+       public:
+        constexpr counter() = default;
+
+        explicit constexpr counter(Index start, Index step = 1) noexcept requires(!Bounded)
+            : start_(start), step_(step) {}
 
+        constexpr counter(Index start, Index step, std::size_t count) noexcept requires Bounded
+            : start_(start), step_(step), count_(count) {}
 
-    struct counter {
-        [[nodiscard]] constexpr static counting_iterator begin() noexcept {
-            return counting_iterator{};
+        [[nodiscard]] constexpr counting_iterator<Index> begin() const noexcept {
+            return {start_, step_};
         }
 
-        [[nodiscard]] constexpr static counting_iterator end() noexcept {
-            return end_count;
+        [[nodiscard]] constexpr auto end() const noexcept {
+            if constexpr (Bounded) {
+                return begin() + static_cast<std::int64_t>(count_);
+            } else {
+                return std::unreachable_sentinel;
+            }
         }
+
+        [[nodiscard]] constexpr std::size_t size() const noexcept requires Bounded {
+            return count_;
+        }
+
+       private:
+        Index start_ = 0;
+        Index step_ = 1;
+        [[no_unique_address]] std::conditional_t<Bounded, std::size_t, utils::empty> count_{};
     };
 
 
-    static_assert(std::forward_iterator<counting_iterator>);
-    static_assert(std::ranges::forward_range<counter>);
+    static_assert(std::random_access_iterator<counting_iterator<>>);
+    static_assert(std::random_access_iterator<counting_iterator<std::uint32_t>>);
+    static_assert(std::ranges::random_access_range<counter<>>);
+    static_assert(utils::unbounded_range<counter<>>);
+    static_assert(std::ranges::sized_range<counter<int, true>>);
 
 }  // namespace zip_utils::detail::counter
+
+
+namespace std::ranges {
+
+    // Counting iterators hold their own indices
+    template <integral Index, bool Bounded>
+    inline constexpr bool enable_borrowed_range<zip_utils::detail::counter::counter<Index, Bounded>> = true;
+
+}  // namespace std::ranges
+
+
+namespace zip_utils::detail::utils {
+
+    // A count at an offset is a multiply-add away from the start
+    template <std::integral Index>
+    constexpr bool enable_offset_addressing<counter::counting_iterator<Index>> = true;
+
+}  // namespace zip_utils::detail::utils
@@ -1,195 +1,1128 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <compare>
 #include <concepts>
 #include <cstddef>
 #include <exception>
+#include <functional>
+#include <limits>
+#include <source_location>
+#include <span>
 #include <tuple>
 #include <type_traits>
 
 #include "configuration.hpp"
+#include "instrumentation.hpp"
+#include "prefetch.hpp"
 #include "utils.hpp"
 
 
 namespace zip_utils::detail::impl {
 
 
-    template <configuration::zip_config Config, typename Mask, std::forward_iterator... Iterators>
-    class zip_value : private std::tuple<Iterators...> {
-       private:
+    // Row of a zip: owning as its value_type, or a row of element references returned by its iterators
+    template <typename... Values>
+    class zip_row : public std::tuple<Values...> {
+        using base = std::tuple<Values...>;
+
+        template <typename Row, std::size_t... Indices>
+        constexpr zip_row(Row &row, std::index_sequence<Indices...>) : base(std::get<Indices>(row)...) {}
+
+        template <typename Row>
+        constexpr void assign(Row &&row) const {
+            [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                ((std::get<Indices>(static_cast<base const &>(*this)) = std::get<Indices>(std::forward<Row>(row))),
+                 ...);
+            }
+            (std::index_sequence_for<Values...>{});
+        }
+
+        template <typename Row>
+        static constexpr bool assignable_from = []<std::size_t... Indices>(std::index_sequence<Indices...>) {
+            return (std::is_assignable_v<Values const &, decltype(std::get<Indices>(std::declval<Row>()))> && ...);
+        }
+        (std::index_sequence_for<Values...>{});
+
+       public:
+        using base::base;
+
+        // Binds a row of references to a mutable row, which std::tuple only allows since C++23
+        template <typename... Others>
+        constexpr zip_row(zip_row<Others...> &other) requires(sizeof...(Others) == sizeof...(Values) &&
+                                                             (std::constructible_from<Values, Others &> && ...))
+            : zip_row(other, std::index_sequence_for<Others...>{}) {}
+
+        // Rows of references assign through to the elements, also when const like the rows of a dereference
+        template <typename... Others>
+        constexpr zip_row &operator=(zip_row<Others...> const &other)
+            requires(sizeof...(Others) == sizeof...(Values) && assignable_from<zip_row<Others...> const &>) {
+            assign(other);
+            return *this;
+        }
+
+        template <typename... Others>
+        constexpr zip_row &operator=(zip_row<Others...> &&other)
+            requires(sizeof...(Others) == sizeof...(Values) && assignable_from<zip_row<Others...> &&>) {
+            assign(std::move(other));
+            return *this;
+        }
+
+        template <typename... Others>
+        constexpr zip_row const &operator=(zip_row<Others...> const &other) const
+            requires(sizeof...(Others) == sizeof...(Values) && assignable_from<zip_row<Others...> const &>) {
+            assign(other);
+            return *this;
+        }
+
+        template <typename... Others>
+        constexpr zip_row const &operator=(zip_row<Others...> &&other) const
+            requires(sizeof...(Others) == sizeof...(Values) && assignable_from<zip_row<Others...> &&>) {
+            assign(std::move(other));
+            return *this;
+        }
+
+        // Swaps the elements of two rows of references, so the rows of a dereference can be swapped
+        friend constexpr void swap(zip_row const &lhs, zip_row const &rhs) noexcept(
+            (std::is_nothrow_swappable_v<Values const &> && ...)) requires(std::is_swappable_v<Values const &> &&...) {
+            [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                (std::ranges::swap(std::get<Indices>(static_cast<base const &>(lhs)),
+                                   std::get<Indices>(static_cast<base const &>(rhs))),
+                 ...);
+            }
+            (std::index_sequence_for<Values...>{});
+        }
+
+        template <std::size_t I>
+        constexpr decltype(auto) get() &noexcept {
+            return std::get<I>(static_cast<base &>(*this));
+        }
+
+        template <std::size_t I>
+        constexpr decltype(auto) get() const &noexcept {
+            return std::get<I>(static_cast<base const &>(*this));
+        }
+
+        template <std::size_t I>
+        constexpr decltype(auto) get() &&noexcept {
+            return std::get<I>(static_cast<base &&>(*this));
+        }
+
+        template <std::size_t I>
+        constexpr decltype(auto) get() const &&noexcept {
+            return std::get<I>(static_cast<base const &&>(*this));
+        }
+    };
+
+
+    // Several offset addressable components share one offset from their first positions: a step is one
+    // addition and a comparison is one comparison, whatever the number of components
+    template <typename... Iterators>
+    inline constexpr bool compact_layout = sizeof...(Iterators) > 1 && (utils::offset_addressable<Iterators> && ...);
+
+
+    // The components of a zip value: the iterators themselves
+    template <bool Compact, typename... Iterators>
+    class zip_storage : private std::tuple<Iterators...> {
         using base = std::tuple<Iterators...>;
 
        public:
         using base::base;
 
-        constexpr void increment() noexcept(requires(Iterators... its) {
-                                                { (++its, ...) } noexcept;
-                                            }) {
-            if (requires(Iterators... its) {
-                    { (++its, ...) } noexcept;
-                }) {
-                // noexcept
+        template <std::size_t I>
+        constexpr auto &iterator() noexcept {
+            return std::get<I>(static_cast<base &>(*this));
+        }
+
+        template <std::size_t I>
+        constexpr auto const &iterator() const noexcept {
+            return std::get<I>(static_cast<base const &>(*this));
+        }
+
+        template <std::size_t I>
+        constexpr decltype(auto) element() const noexcept(noexcept(*std::declval<utils::get_at<I, Iterators...> const &>())) {
+            return *iterator<I>();
+        }
+    };
+
+    // ... or their first positions and a shared offset
+    template <typename... Iterators>
+    class zip_storage<true, Iterators...> {
+       public:
+        constexpr zip_storage() = default;
+
+        explicit constexpr zip_storage(Iterators... firsts) noexcept(
+            (std::is_nothrow_move_constructible_v<Iterators> && ...))
+            : firsts_(std::move(firsts)...) {}
+
+        constexpr zip_storage(std::ptrdiff_t offset, Iterators... firsts) noexcept(
+            (std::is_nothrow_move_constructible_v<Iterators> && ...))
+            : firsts_(std::move(firsts)...), offset_(offset) {}
+
+        template <std::size_t I>
+        constexpr auto iterator() const noexcept(noexcept(std::get<I>(firsts_) + std::ptrdiff_t{})) {
+            using iterator_type = utils::get_at<I, Iterators...>;
+            return std::get<I>(firsts_) + static_cast<std::iter_difference_t<iterator_type>>(offset_);
+        }
+
+        // Contiguous components are read through their first pointers
+        template <std::size_t I>
+        constexpr decltype(auto) element() const noexcept(noexcept(*iterator<I>())) {
+            if constexpr (std::contiguous_iterator<utils::get_at<I, Iterators...>>) {
+                return *(std::to_address(std::get<I>(firsts_)) + offset_);
+            } else {
+                return *iterator<I>();
+            }
+        }
+
+        constexpr std::ptrdiff_t &offset() noexcept {
+            return offset_;
+        }
+
+        constexpr std::ptrdiff_t offset() const noexcept {
+            return offset_;
+        }
+
+       private:
+        [[no_unique_address]] std::tuple<Iterators...> firsts_{};
+        std::ptrdiff_t offset_ = 0;
+    };
+
+
+    // The positions of a zip, one per input. Its rows are read by value with row(), iter_move and
+    // iter_swap go through the elements; copies and assignments only move the positions.
+    template <configuration::zip_config Config, typename Mask, std::input_iterator... Iterators>
+    class zip_value : private zip_storage<compact_layout<Iterators...>, Iterators...> {
+       public:
+        static constexpr bool compact = compact_layout<Iterators...>;
+
+       private:
+        using base = zip_storage<compact, Iterators...>;
+
+        static constexpr bool multi_pass = (std::forward_iterator<Iterators> && ...);
+        static constexpr bool equal_lengths = configuration::contains<Config, configuration::zip_config::EQUAL_LENGTHS>;
+
+        template <typename Operation>
+        static constexpr bool nothrow_applicable = (std::is_nothrow_invocable_v<Operation &, Iterators &> && ...);
+
+        // Indices of the components whose operation may throw, in order
+        template <typename Operation>
+        static constexpr auto throwing_indices() noexcept {
+            constexpr std::array<bool, sizeof...(Iterators)> throws = {
+                !std::is_nothrow_invocable_v<Operation &, Iterators &>...};
+            constexpr auto count = static_cast<std::size_t>(std::ranges::count(throws, true));
+            constexpr auto indices = [&] {
+                std::array<std::size_t, count> result{};
+                for (std::size_t i = 0, j = 0; i < throws.size(); ++i) {
+                    if (throws[i]) {
+                        result[j++] = i;
+                    }
+                }
+                return result;
+            }();
+            return [&]<std::size_t... J>(std::index_sequence<J...>) {
+                return std::index_sequence<indices[J]...>{};
+            }
+            (std::make_index_sequence<count>{});
+        }
+
+        template <typename Inverse, std::size_t... Indices>
+        static constexpr bool nothrow_invertible =
+            (std::is_nothrow_invocable_v<Inverse &, utils::get_at<Indices, Iterators...> &> && ...);
+
+        template <typename Operation, typename Inverse>
+        constexpr void apply(Operation &&operation, Inverse &&inverse) noexcept(nothrow_applicable<Operation>) {
+            using namespace configuration;
+            auto &self = *this;
+            if constexpr (nothrow_applicable<Operation> || contains<Config, zip_config::BASIC_EXCEPTION_GUARANTEE> ||
+                          !multi_pass) {
+                // noexcept or basic exception guarantee, single pass iterators can not be restored anyway
                 [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
-                    (++std::get<Indices>(static_cast<base &>(*this)), ...);
+                    (operation(self.template iterator<Indices>()), ...);
                 }
                 (std::make_index_sequence<sizeof...(Iterators)>{});
             } else {
-                // strong exception guarantee
-                static_assert(std::is_nothrow_move_assignable_v<zip_value>,
-                              "One or more iterators are not nothrow assignable.");
+                // strong exception guarantee: throwing components go first, so only they may need restoring
+                [&]<std::size_t... Throwing>(std::index_sequence<Throwing...>) {
+                    if constexpr (contains<Config, zip_config::UNDO_ON_EXCEPTION> &&
+                                  nothrow_invertible<Inverse, Throwing...>) {
+                        // a component that throws is expected to stay unchanged
+                        std::size_t done = 0;
+                        try {
+                            ((operation(self.template iterator<Throwing>()), ++done), ...);
+                        } catch (...) {
+                            std::size_t index = 0;
+                            ((index++ < done ? inverse(self.template iterator<Throwing>()) : void()), ...);
+                            std::rethrow_exception(std::current_exception());
+                        }
+                    } else {
+                        static_assert((std::is_nothrow_move_assignable_v<utils::get_at<Throwing, Iterators...>> && ...),
+                                      "One or more iterators are not nothrow assignable.");
 
-                zip_value copy = *this;
-                try {
-                    [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
-                        (++std::get<Indices>(static_cast<base &>(*this)), ...);
+                        std::tuple<utils::get_at<Throwing, Iterators...>...> snapshot(self.template iterator<Throwing>()...);
+                        try {
+                            (operation(self.template iterator<Throwing>()), ...);
+                        } catch (...) {
+                            [&]<std::size_t... J>(std::index_sequence<J...>) {
+                                ((self.template iterator<Throwing>() = std::move(std::get<J>(snapshot))), ...);
+                            }
+                            (std::index_sequence_for<utils::get_at<Throwing, Iterators...>...>{});
+                            std::rethrow_exception(std::current_exception());
+                        }
                     }
-                    (std::make_index_sequence<sizeof...(Iterators)>{});
-                } catch (...) {
-                    *this = std::move(copy);
-                    std::rethrow_exception(std::current_exception());
                 }
+                (throwing_indices<Operation>());
+
+                [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    ((std::is_nothrow_invocable_v<Operation &, Iterators &> ? operation(self.template iterator<Indices>())
+                                                                               : void()),
+                     ...);
+                }
+                (std::make_index_sequence<sizeof...(Iterators)>{});
             }
         }
 
-        constexpr bool equals(zip_value const &other) const noexcept(requires(Iterators... its) {
-                                                                         { ((its == its), ...) } noexcept;
-                                                                     }) {
-            auto &self = static_cast<base const &>(*this);
-            auto &that = static_cast<base const &>(other);
-            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
-                return ((std::get<Indices>(self) == std::get<Indices>(that)) || ...);
+        static constexpr auto increment_one = [](auto &iterator) noexcept(noexcept(++iterator)) { ++iterator; };
+        static constexpr auto decrement_one = []<std::bidirectional_iterator Iterator>(Iterator &iterator) noexcept(
+                                                  noexcept(--iterator)) { --iterator; };
+
+       public:
+        using base::base;
+
+        constexpr zip_value() = default;
+
+        // Calls `reader` with the iterators
+        template <typename Reader>
+        constexpr decltype(auto) read_iterators(Reader &&reader) const {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>)->decltype(auto) {
+                return std::forward<Reader>(reader)(this->template iterator<Indices>()...);
             }
             (std::make_index_sequence<sizeof...(Iterators)>{});
         }
 
         template <std::size_t I>
-        constexpr auto &&get() &noexcept(noexcept(std::get<I>(static_cast<base &>(*this)))) {
-            using namespace configuration;
-            auto &self = static_cast<base &>(*this);
-            if constexpr (utils::mask_element<I, Mask> && contains<Config, zip_config::MOVE_FROM_RVALUES>) {
-                return std::move(*std::get<I>(self));
+        static constexpr bool moved_element =
+            std::is_reference_v<std::iter_reference_t<utils::get_at<I, Iterators...>>> &&
+            utils::mask_element<I, Mask> && configuration::contains<Config, configuration::zip_config::MOVE_FROM_RVALUES>;
+
+        template <std::size_t I>
+        using row_element =
+            std::conditional_t<moved_element<I>, std::iter_rvalue_reference_t<utils::get_at<I, Iterators...>>,
+                               std::iter_reference_t<utils::get_at<I, Iterators...>>>;
+
+        // The elements in place, as returned by a dereference: inputs moved from give rvalue references
+        constexpr auto row() const noexcept((noexcept(*std::declval<Iterators const &>()) && ...)) {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                return zip_row<row_element<Indices>...>(
+                    static_cast<row_element<Indices>>(this->template element<Indices>())...);
+            }
+            (std::make_index_sequence<sizeof...(Iterators)>{});
+        }
+
+        constexpr auto move_row() const noexcept(requires(Iterators... its) {
+            { (std::ranges::iter_move(its), ...) } noexcept;
+        }) {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                return zip_row<std::iter_rvalue_reference_t<Iterators>...>(
+                    std::ranges::iter_move(this->template iterator<Indices>())...);
+            }
+            (std::make_index_sequence<sizeof...(Iterators)>{});
+        }
+
+        constexpr void swap_elements(zip_value const &other) const noexcept(requires(Iterators... its) {
+            { (std::ranges::iter_swap(its, its), ...) } noexcept;
+        }) {
+            [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                (std::ranges::iter_swap(this->template iterator<Indices>(), other.template iterator<Indices>()), ...);
+            }
+            (std::make_index_sequence<sizeof...(Iterators)>{});
+        }
+
+        constexpr void increment() noexcept(compact || nothrow_applicable<decltype(increment_one)>) {
+            if constexpr (compact) {
+                ++this->offset();
             } else {
-                return *std::get<I>(self);
+                apply(increment_one, decrement_one);
             }
         }
 
-        template <std::size_t I>
-        constexpr auto const &get() const &noexcept(noexcept(std::get<I>(static_cast<base const &>(*this)))) {
-            auto self = static_cast<base const &>(*this);
-            return *std::get<I>(self);
+        constexpr void decrement() noexcept(compact || nothrow_applicable<decltype(decrement_one)>)
+            requires(std::bidirectional_iterator<Iterators> &&...) {
+            if constexpr (compact) {
+                --this->offset();
+            } else {
+                apply(decrement_one, increment_one);
+            }
         }
 
-        template <std::size_t I>
-        constexpr auto get() &&noexcept(noexcept(std::get<I>(static_cast<base &&>(*this)))) {
-            using namespace configuration;
-            auto &&self = static_cast<base &&>(*this);
-            if constexpr (utils::mask_element<I, Mask> && contains<Config, zip_config::MOVE_FROM_RVALUES>) {
-                return std::move(*std::get<I>(self));
+        constexpr void advance(std::ptrdiff_t n) noexcept(compact || requires(Iterators... its, std::ptrdiff_t d) {
+            { ((its += d), ...) } noexcept;
+        }) requires(std::random_access_iterator<Iterators> &&...) {
+            if constexpr (compact) {
+                this->offset() += n;
+            } else {
+                apply([n](auto &iterator) noexcept(noexcept(iterator += 1)) {
+                    iterator += static_cast<std::iter_difference_t<decltype(iterator)>>(n);
+                }, [n](auto &iterator) noexcept(noexcept(iterator -= 1)) {
+                    iterator -= static_cast<std::iter_difference_t<decltype(iterator)>>(n);
+                });
+            }
+        }
+
+        // End iterators of random access zips are aligned, so the first component determines the distance.
+        // Compact values of one zip share their first positions, so their offsets do.
+        constexpr std::ptrdiff_t distance_to(zip_value const &other) const noexcept(compact || requires(Iterators... its) {
+            { ((its - its), ...) } noexcept;
+        }) requires(std::random_access_iterator<Iterators> &&...) {
+            if constexpr (compact) {
+                return other.offset() - this->offset();
             } else {
-                return *std::get<I>(self);
+                return static_cast<std::ptrdiff_t>(other.template iterator<0>() - this->template iterator<0>());
             }
         }
+
+        constexpr bool equals(zip_value const &other) const noexcept(compact || requires(Iterators... its) {
+            { ((its == its), ...) } noexcept;
+        }) {
+            if constexpr (compact) {
+                return this->offset() == other.offset();
+            } else if constexpr ((std::random_access_iterator<Iterators> && ...)) {
+                // a single comparison, components move in lockstep from aligned ends
+                return this->template iterator<0>() == other.template iterator<0>();
+            } else if constexpr (equal_lengths) {
+                // components of equal length inputs also reach their ends together
+                bool const equal = this->template iterator<0>() == other.template iterator<0>();
+                assert(ends_together(reached_each(other.read_iterators([](Iterators const &...its) {
+                           return std::tuple(its...);
+                       })),
+                                     equal) &&
+                       "Inputs of an EQUAL_LENGTHS zip differ in length");
+                return equal;
+            } else {
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return ((this->template iterator<Indices>() == other.template iterator<Indices>()) || ...);
+                }
+                (std::make_index_sequence<sizeof...(Iterators)>{});
+            }
+        }
+
+        // Any component reaching its sentinel ends the zip
+        template <typename... Sentinels>
+        constexpr bool reached(std::tuple<Sentinels...> const &sentinels) const noexcept(requires(Iterators... its,
+                                                                                                  Sentinels... ends) {
+            { ((its == ends), ...) } noexcept;
+        }) requires(sizeof...(Sentinels) == sizeof...(Iterators)) {
+            if constexpr (equal_lengths) {
+                constexpr std::size_t lead = utils::first_bounded<std::same_as<Sentinels, std::unreachable_sentinel_t>...>;
+                bool const reached = this->template iterator<lead>() == std::get<lead>(sentinels);
+                assert(ends_together<Sentinels...>(reached_each(sentinels), reached) &&
+                       "Inputs of an EQUAL_LENGTHS zip differ in length");
+                return reached;
+            } else {
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return ((this->template iterator<Indices>() == std::get<Indices>(sentinels)) || ...);
+                }
+                (std::make_index_sequence<sizeof...(Iterators)>{});
+            }
+        }
+
+        // Whether every bounded component is at its end exactly when the lead one is
+        template <typename... Sentinels>
+        static constexpr bool ends_together(std::array<bool, sizeof...(Iterators)> const &reached, bool lead) noexcept {
+            constexpr std::array<bool, sizeof...(Iterators)> unbounded = {
+                std::same_as<Sentinels, std::unreachable_sentinel_t>...};
+            for (std::size_t i = 0; i < reached.size(); ++i) {
+                if (!unbounded[i] && reached[i] != lead) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Which components reached their sentinels
+        template <typename... Sentinels>
+        constexpr auto reached_each(std::tuple<Sentinels...> const &sentinels) const
+            requires(sizeof...(Sentinels) == sizeof...(Iterators)) {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                return std::array<bool, sizeof...(Iterators)>{
+                    (this->template iterator<Indices>() == std::get<Indices>(sentinels))...};
+            }
+            (std::make_index_sequence<sizeof...(Iterators)>{});
+        }
+
+        // The closest sentinel determines the distance
+        template <typename... Sentinels>
+        constexpr std::ptrdiff_t distance_to(std::tuple<Sentinels...> const &sentinels) const
+            noexcept(requires(Iterators... its, Sentinels... ends) {
+                { ((ends - its), ...) } noexcept;
+            }) requires(std::sized_sentinel_for<Sentinels, Iterators> &&...) {
+            return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                return std::min(
+                    {static_cast<std::ptrdiff_t>(std::get<Indices>(sentinels) - this->template iterator<Indices>())...});
+            }
+            (std::make_index_sequence<sizeof...(Iterators)>{});
+        }
+    };
+
+
+    // Counted sentinels keep only the zip size, the others keep a sentinel for each input
+    template <bool Counted, typename... Sentinels>
+    class zip_sentinel {
+       public:
+        constexpr zip_sentinel() = default;
+
+        explicit constexpr zip_sentinel(Sentinels... sentinels) noexcept(
+            (std::is_nothrow_move_constructible_v<Sentinels> && ...)) requires(!Counted)
+            : bound_(std::move(sentinels)...) {}
+
+        explicit constexpr zip_sentinel(std::ptrdiff_t position) noexcept requires Counted : bound_(position) {}
+
+        constexpr std::tuple<Sentinels...> const &sentinels() const noexcept requires(!Counted) {
+            return bound_;
+        }
+
+        constexpr std::ptrdiff_t position() const noexcept requires Counted {
+            return bound_;
+        }
+
+       private:
+        std::conditional_t<Counted, std::ptrdiff_t, std::tuple<Sentinels...>> bound_{};
     };
 
 
-    template <configuration::zip_config Config, typename Mask, std::forward_iterator... Iterators>
+    // Counted iterators of sized zips finish on a position comparison instead of comparing every component
+    template <configuration::zip_config Config, typename Mask, bool Counted, std::input_iterator... Iterators>
     class zip_iterator : private zip_value<Config, Mask, Iterators...> {
        private:
         using base = zip_value<Config, Mask, Iterators...>;
+        using position_type = std::conditional_t<Counted, std::ptrdiff_t, utils::empty_slot<0>>;
+        using lookahead = prefetch::lookahead<Iterators...>;
 
        public:
+        static constexpr bool prefetching =
+            configuration::contains<Config, configuration::zip_config::PREFETCH> && lookahead::enabled;
+        static constexpr bool instrumented = configuration::contains<Config, configuration::zip_config::INSTRUMENT>;
+
         explicit constexpr zip_iterator(Iterators &&...iterators) noexcept(
             noexcept(base(std::forward<Iterators>(iterators)...)))
             : base(std::forward<Iterators>(iterators)...) {}
 
+        constexpr zip_iterator(std::ptrdiff_t position, Iterators &&...iterators) noexcept(
+            noexcept(base(std::forward<Iterators>(iterators)...))) requires Counted
+            : base(std::forward<Iterators>(iterators)...),
+              position_(position) {}
+
+        // Compact iterators of a random access zip start at an offset from the first positions of its inputs
+        constexpr zip_iterator(std::ptrdiff_t offset, Iterators &&...firsts) noexcept(
+            noexcept(base(offset, std::forward<Iterators>(firsts)...))) requires base::compact
+            : base(offset, std::forward<Iterators>(firsts)...) {}
+
         constexpr zip_iterator() noexcept(noexcept(base())) = default;
 
-        using value_type = base;
-        using reference = value_type &;
-        using const_reference = value_type const &;
-        using difference_type = int;
-        using iterator_category = std::forward_iterator_tag;
+        // Rows are returned by value as tuples of element references, like std::views::zip: a row never
+        // refers into the iterator, so reverse iterators and copies of the zip may dereference temporaries
+        using value_type = zip_row<std::iter_value_t<Iterators>...>;
+        using reference = decltype(std::declval<base const &>().row());
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = utils::weakest_iterator_tag<Iterators...>;
+        using iterator_category = iterator_concept;
 
-        constexpr reference operator*() const noexcept {
-            return const_cast<reference>(static_cast<const_reference>(*this));
+        constexpr reference operator*() const noexcept(noexcept(this->row())) {
+            return this->row();
+        }
+
+        constexpr reference operator[](difference_type n) const
+            noexcept(noexcept(*(*this + n))) requires(std::random_access_iterator<Iterators> &&...) {
+            return *(*this + n);
+        }
+
+        friend constexpr auto iter_move(zip_iterator const &it) noexcept(noexcept(it.move_row())) {
+            return it.move_row();
+        }
+
+        friend constexpr void iter_swap(zip_iterator const &lhs, zip_iterator const &rhs) noexcept(
+            noexcept(lhs.swap_elements(rhs))) requires(std::indirectly_swappable<Iterators> &&...) {
+            lhs.swap_elements(rhs);
         }
 
         constexpr zip_iterator &operator++() noexcept(noexcept(this->increment())) {
             this->increment();
+            if constexpr (Counted) {
+                ++position_;
+            }
+            if constexpr (prefetching) {
+                if (!std::is_constant_evaluated()) {
+                    lookahead_.step();
+                }
+            }
+            if constexpr (instrumented) {
+                probe_.step(1);
+            }
             return *this;
         }
 
+        // Starts the prefetch cursors of a begin iterator of a zip of `size` rows
+        constexpr void start_prefetch(std::size_t size) noexcept(
+            std::is_nothrow_copy_constructible_v<lookahead>) requires prefetching {
+            if (!std::is_constant_evaluated()) {
+                this->read_iterators([&](Iterators const &...iterators) {
+                    lookahead_ = lookahead(configuration::prefetch_distance<Config>, static_cast<std::ptrdiff_t>(size),
+                                           iterators...);
+                });
+            }
+        }
+
+        // Starts recording the iteration from this begin iterator, see instrumentation::probe
+        void start_probe(std::source_location const &site, std::array<std::size_t, sizeof...(Iterators)> const &sizes)
+            requires instrumented {
+            probe_.start(site, sizes);
+        }
+
         constexpr zip_iterator operator++(int) &noexcept(
-            std::is_nothrow_copy_constructible_v<zip_iterator> &&noexcept(this->increment())) {
+            std::is_nothrow_copy_constructible_v<zip_iterator> &&noexcept(this->increment()))
+            requires(std::forward_iterator<Iterators> &&...) {
             auto copy = *this;
-            this->increment();
+            ++*this;
             return copy;
         }
 
+        // Single pass iterators can not keep the previous position
+        constexpr void operator++(int) &noexcept(noexcept(this->increment()))
+            requires(!(std::forward_iterator<Iterators> && ...)) {
+            ++*this;
+        }
+
+        constexpr zip_iterator &operator--() noexcept(noexcept(this->decrement()))
+            requires(std::bidirectional_iterator<Iterators> &&...) {
+            this->decrement();
+            if constexpr (Counted) {
+                --position_;
+            }
+            if constexpr (instrumented) {
+                probe_.step(-1);
+            }
+            return *this;
+        }
+
+        constexpr zip_iterator operator--(int) &noexcept(
+            std::is_nothrow_copy_constructible_v<zip_iterator> &&noexcept(this->decrement()))
+            requires(std::bidirectional_iterator<Iterators> &&...) {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        constexpr zip_iterator &operator+=(difference_type n) noexcept(noexcept(this->advance(n)))
+            requires(std::random_access_iterator<Iterators> &&...) {
+            this->advance(n);
+            if constexpr (instrumented) {
+                probe_.step(n);
+            }
+            return *this;
+        }
+
+        constexpr zip_iterator &operator-=(difference_type n) noexcept(noexcept(this->advance(-n)))
+            requires(std::random_access_iterator<Iterators> &&...) {
+            this->advance(-n);
+            if constexpr (instrumented) {
+                probe_.step(-n);
+            }
+            return *this;
+        }
+
+        friend constexpr zip_iterator operator+(zip_iterator it, difference_type n) noexcept(noexcept(it += n))
+            requires(std::random_access_iterator<Iterators> &&...) {
+            return it += n;
+        }
+
+        friend constexpr zip_iterator operator+(difference_type n, zip_iterator it) noexcept(noexcept(it += n))
+            requires(std::random_access_iterator<Iterators> &&...) {
+            return it += n;
+        }
+
+        friend constexpr zip_iterator operator-(zip_iterator it, difference_type n) noexcept(noexcept(it -= n))
+            requires(std::random_access_iterator<Iterators> &&...) {
+            return it -= n;
+        }
+
+        friend constexpr difference_type operator-(zip_iterator const &lhs, zip_iterator const &rhs) noexcept(
+            noexcept(rhs.distance_to(lhs))) requires(std::random_access_iterator<Iterators> &&...) {
+            return rhs.distance_to(lhs);
+        }
+
         constexpr bool operator==(zip_iterator const &other) const noexcept(noexcept(this->equals(other))) {
-            return this->equals(other);
+            bool equal = false;
+            if constexpr (Counted) {
+                equal = position_ == other.position_;
+            } else {
+                equal = this->equals(other);
+            }
+            if constexpr (instrumented) {
+                if (equal && !std::is_constant_evaluated()) {
+                    // end iterators have no probe of their own
+                    if (!other.probe_.active()) {
+                        note_end(other.read_iterators([](Iterators const &...ends) { return std::tuple(ends...); }));
+                    } else if (!probe_.active()) {
+                        other.note_end(this->read_iterators([](Iterators const &...ends) { return std::tuple(ends...); }));
+                    }
+                }
+            }
+            return equal;
+        }
+
+        constexpr bool operator!=(zip_iterator const &other) const noexcept(noexcept(*this == other)) {
+            return !(*this == other);
+        }
+
+        template <typename... Sentinels>
+        constexpr bool operator==(zip_sentinel<false, Sentinels...> const &sentinel) const
+            noexcept(noexcept(this->reached(sentinel.sentinels()))) requires(!Counted) {
+            bool const reached = this->reached(sentinel.sentinels());
+            if constexpr (instrumented) {
+                if (reached && !std::is_constant_evaluated()) {
+                    note_end(sentinel.sentinels());
+                }
+            }
+            return reached;
+        }
+
+        template <typename... Sentinels>
+        constexpr bool operator==(zip_sentinel<true, Sentinels...> const &sentinel) const noexcept requires Counted {
+            bool const reached = position_ == sentinel.position();
+            if constexpr (instrumented) {
+                if (reached && !std::is_constant_evaluated()) {
+                    // the sizes of counted zips are known from the start
+                    probe_.reach({});
+                }
+            }
+            return reached;
+        }
+
+        template <typename... Sentinels>
+        friend constexpr difference_type operator-(zip_sentinel<false, Sentinels...> const &sentinel,
+                                                   zip_iterator const &it) noexcept(noexcept(it.distance_to(
+            sentinel.sentinels()))) requires(!Counted && (std::sized_sentinel_for<Sentinels, Iterators> && ...)) {
+            return it.distance_to(sentinel.sentinels());
+        }
+
+        template <typename... Sentinels>
+        friend constexpr difference_type operator-(zip_sentinel<true, Sentinels...> const &sentinel,
+                                                   zip_iterator const &it) noexcept requires Counted {
+            return sentinel.position() - it.position_;
         }
 
-        constexpr bool operator!=(zip_iterator const &other) const noexcept(noexcept(this->equals(other))) {
-            return !this->equals(other);
+        template <typename... Sentinels>
+        friend constexpr difference_type operator-(zip_iterator const &it,
+                                                   zip_sentinel<Counted, Sentinels...> const &sentinel) noexcept(
+            noexcept(sentinel - it)) requires(Counted || (std::sized_sentinel_for<Sentinels, Iterators> && ...)) {
+            return -(sentinel - it);
         }
+
+        constexpr std::strong_ordering operator<=>(zip_iterator const &other) const
+            noexcept(noexcept(other.distance_to(*this))) requires(std::random_access_iterator<Iterators> &&...) {
+            return other.distance_to(*this) <=> 0;
+        }
+
+       private:
+        template <typename Ends>
+        void note_end(Ends const &ends) const requires instrumented {
+            if (probe_.active()) {
+                probe_.reach(this->reached_each(ends));
+            }
+        }
+
+        [[no_unique_address]] position_type position_{};
+        [[no_unique_address]] std::conditional_t<prefetching, lookahead, utils::empty_slot<1>> lookahead_{};
+        [[no_unique_address]] mutable std::conditional_t<instrumented, instrumentation::probe<sizeof...(Iterators)>,
+                                                         utils::empty_slot<2>> probe_{};
     };
 
 
-    template <configuration::zip_config Config, typename Mask, std::forward_iterator... Iterators>
+    template <configuration::zip_config Config, typename Mask, bool Counted, std::input_iterator... Iterators>
     constexpr auto make_zip_iterator(Iterators &&...iterators) noexcept(
-        noexcept(zip_iterator<Config, Mask, Iterators...>(std::forward<Iterators>(iterators)...))) {
-        return zip_iterator<Config, Mask, Iterators...>(std::forward<Iterators>(iterators)...);
+        noexcept(zip_iterator<Config, Mask, Counted, Iterators...>(std::forward<Iterators>(iterators)...))) {
+        return zip_iterator<Config, Mask, Counted, Iterators...>(std::forward<Iterators>(iterators)...);
+    }
+
+    template <configuration::zip_config Config, typename Mask, std::input_iterator... Iterators>
+    constexpr auto make_offset_zip_iterator(std::ptrdiff_t offset, Iterators &&...firsts) noexcept(
+        noexcept(zip_iterator<Config, Mask, false, Iterators...>(offset, std::forward<Iterators>(firsts)...))) {
+        return zip_iterator<Config, Mask, false, Iterators...>(offset, std::forward<Iterators>(firsts)...);
+    }
+
+    template <configuration::zip_config Config, typename Mask, std::input_iterator... Iterators>
+    constexpr auto make_counted_zip_iterator(std::ptrdiff_t position, Iterators &&...iterators) noexcept(
+        noexcept(zip_iterator<Config, Mask, true, Iterators...>(position, std::forward<Iterators>(iterators)...))) {
+        return zip_iterator<Config, Mask, true, Iterators...>(position, std::forward<Iterators>(iterators)...);
     }
 
 
-    template <configuration::zip_config Config, std::ranges::forward_range... Containers>
-    class zip_impl : private std::tuple<Containers...> {
-        using base = std::tuple<Containers...>;
-        using mask = utils::types_to_rvalues_mask<Containers &&...>;
+    // Properties of the inputs as seen through a mutable or a const zip
+    template <typename... Ranges>
+    struct zip_properties {
+        static constexpr bool random_access = (std::ranges::random_access_range<Ranges> && ...);
+        static constexpr bool bidirectional = (std::ranges::bidirectional_range<Ranges> && ...);
+
+        // Unbounded inputs do not limit the size, but at least one input has to
+        static constexpr bool sized =
+            ((std::ranges::sized_range<Ranges> || utils::unbounded_range<Ranges>) && ...) &&
+            (std::ranges::sized_range<Ranges> || ...);
+        static constexpr bool counted = sized && !random_access && sizeof...(Ranges) > 1;
+
+        // The size is known from the input types, unbounded inputs aside
+        static constexpr std::size_t extent = [] {
+            if constexpr (((utils::static_extent<Ranges> != std::dynamic_extent || utils::unbounded_range<Ranges>) &&
+                           ...) &&
+                          ((utils::static_extent<Ranges> != std::dynamic_extent) || ...)) {
+                return std::min({(utils::unbounded_range<Ranges> ? std::numeric_limits<std::size_t>::max()
+                                                                 : utils::static_extent<Ranges>)...});
+            } else {
+                return std::dynamic_extent;
+            }
+        }();
+
+        // Ends of several bidirectional inputs are not aligned, so they are only reachable by a sentinel
+        static constexpr bool common =
+            (std::ranges::common_range<Ranges> && ...) && (sizeof...(Ranges) == 1 || !bidirectional);
+    };
+
 
+    template <configuration::zip_config Config, std::ranges::input_range... Containers>
+    class zip_impl : public std::ranges::view_interface<zip_impl<Config, Containers...>> {
         static_assert(sizeof...(Containers) > 0, "At least one container required.");
 
+        // A const zip reads its inputs as const ranges and never moves from them
+        template <typename Self, typename Container>
+        using range_t = std::conditional_t<std::is_const_v<Self>, std::remove_reference_t<Container> const,
+                                           std::remove_reference_t<Container>>;
+
+        template <typename Self>
+        using properties = zip_properties<range_t<Self, Containers>...>;
+
+        template <typename Self>
+        using mask = std::conditional_t<std::is_const_v<Self>, utils::types_to_rvalues_mask<Containers &...>,
+                                        utils::types_to_rvalues_mask<Containers &&...>>;
+
+        static constexpr bool instrumented = configuration::contains<Config, configuration::zip_config::INSTRUMENT>;
+        using call_site = instrumentation::call_site<instrumented>;
+
        public:
-        using std::tuple<Containers...>::tuple;
+        // Instrumented zips keep the location they are created at, see make_zip
+        template <typename... Inputs>
+        requires(sizeof...(Inputs) == sizeof...(Containers))
+        explicit constexpr zip_impl(call_site site, Inputs &&...inputs) noexcept(
+            (std::is_nothrow_constructible_v<utils::stored_input<Containers>, Inputs &&> && ...))
+            : inputs_(std::forward<Inputs>(inputs)...), site_(site) {}
+
+        // Instrumented zips record their iterations under the location they are created at
+        constexpr auto begin() noexcept(noexcept(begin_of(std::declval<zip_impl &>()))) {
+            return begin_of(*this);
+        }
+
+        constexpr auto begin() const noexcept(noexcept(begin_of(std::declval<zip_impl const &>())))
+            requires(std::ranges::input_range<range_t<zip_impl const, Containers>> &&...) {
+            return begin_of(*this);
+        }
 
-        constexpr auto begin() noexcept(requires(Containers... cons) {
-                                            { make_zip_iterator<Config, mask>(std::begin(cons)...) } noexcept;
-                                        }) {
+        constexpr auto end() noexcept(noexcept(end_of(std::declval<zip_impl &>()))) {
+            return end_of(*this);
+        }
+
+        constexpr auto end() const noexcept(noexcept(end_of(std::declval<zip_impl const &>())))
+            requires(std::ranges::input_range<range_t<zip_impl const, Containers>> &&...) {
+            return end_of(*this);
+        }
+
+        // The shortest bounded input size, computed once per call
+        constexpr std::size_t size() noexcept(noexcept(size_of(std::declval<zip_impl &>())))
+            requires properties<zip_impl>::sized {
+            return size_of(*this);
+        }
+
+        constexpr std::size_t size() const noexcept(noexcept(size_of(std::declval<zip_impl const &>())))
+            requires properties<zip_impl const>::sized {
+            return size_of(*this);
+        }
+
+        // Every contiguous input as a span of the zip size
+        constexpr auto spans() noexcept(noexcept(spans_of(std::declval<zip_impl &>())))
+            requires properties<zip_impl>::sized && (std::ranges::contiguous_range<range_t<zip_impl, Containers>> && ...) {
+            return spans_of(*this);
+        }
+
+        constexpr auto spans() const noexcept(noexcept(spans_of(std::declval<zip_impl const &>())))
+            requires properties<zip_impl const>::sized &&
+            (std::ranges::contiguous_range<range_t<zip_impl const, Containers>> && ...) {
+            return spans_of(*this);
+        }
+
+        // Zips of inputs with static extents (see utils::static_extent) have their size in the type
+        static constexpr std::size_t extent = properties<zip_impl>::extent;
+
+        // Rows of fixed extent zips, as tuples of element references
+        template <std::size_t I>
+        constexpr auto get() noexcept(noexcept(row_of<I>(std::declval<zip_impl &>())))
+            requires(extent != std::dynamic_extent && I < extent) {
+            return row_of<I>(*this);
+        }
+
+        template <std::size_t I>
+        constexpr auto get() const noexcept(noexcept(row_of<I>(std::declval<zip_impl const &>())))
+            requires(extent != std::dynamic_extent && I < extent) {
+            return row_of<I>(*this);
+        }
+
+        // Calls `function` with every row, fixed extent zips are expanded to straight-line calls
+        template <typename Function>
+        constexpr Function for_each(Function function) {
+            for_each_of(*this, function);
+            return function;
+        }
+
+        template <typename Function>
+        constexpr Function for_each(Function function) const {
+            for_each_of(*this, function);
+            return function;
+        }
+
+       private:
+        static constexpr std::size_t max_unrolled_extent = 64;
+
+        template <std::size_t I, typename Self>
+        static constexpr auto &range(Self &self) noexcept {
+            return static_cast<range_t<Self, utils::get_at<I, Containers...>> &>(std::get<I>(self.inputs_).get());
+        }
+
+        template <typename Self>
+        static constexpr auto begin_of(Self &self) noexcept(!instrumented && requires(
+            range_t<Self, Containers> &...ranges) {
+            {
+                make_zip_iterator<Config, mask<Self>, properties<Self>::counted>(std::ranges::begin(ranges)...)
+                } noexcept;
+        }) {
+            auto make = [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                return make_zip_iterator<Config, mask<Self>, properties<Self>::counted>(
+                    std::ranges::begin(range<Indices>(self))...);
+            };
+            using iterator = decltype(make(std::make_index_sequence<sizeof...(Containers)>{}));
+            if constexpr ((properties<Self>::sized && iterator::prefetching) || instrumented) {
+                auto first = make(std::make_index_sequence<sizeof...(Containers)>{});
+                if constexpr (properties<Self>::sized && iterator::prefetching) {
+                    first.start_prefetch(size_of(self));
+                }
+                if constexpr (instrumented) {
+                    if (!std::is_constant_evaluated()) {
+                        auto const sizes = [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                            return std::array<std::size_t, sizeof...(Containers)>{
+                                probed_size(range<Indices>(self))...};
+                        }(std::make_index_sequence<sizeof...(Containers)>{});
+                        first.start_probe(self.site_.location, sizes);
+                    }
+                }
+                return first;
+            } else {
+                return make(std::make_index_sequence<sizeof...(Containers)>{});
+            }
+        }
+
+        template <typename Self>
+        static constexpr auto end_of(Self &self) noexcept(
+            requires(range_t<Self, Containers> &...ranges) {
+                { (std::ranges::end(ranges), ...) } noexcept;
+            } && (!(properties<Self>::random_access && properties<Self>::sized) ||
+                  requires(range_t<Self, Containers> &...ranges, std::ptrdiff_t count) {
+                      {size_of(self)} noexcept;
+                      {make_zip_iterator<Config, mask<Self>, false>((std::ranges::begin(ranges) + count)...)} noexcept;
+                  }) && (!properties<Self>::counted || requires {
+                {size_of(self)} noexcept;
+            })) {
+            using props = properties<Self>;
+            if constexpr (props::random_access && props::sized &&
+                          compact_layout<std::ranges::iterator_t<range_t<Self, Containers>>...>) {
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return make_offset_zip_iterator<Config, mask<Self>>(static_cast<std::ptrdiff_t>(size_of(self)),
+                                                                        std::ranges::begin(range<Indices>(self))...);
+                }
+                (std::make_index_sequence<sizeof...(Containers)>{});
+            } else if constexpr (props::random_access && props::sized) {
+                // Aligns the components to the shortest input, so the end iterator can be moved backwards
+                auto const count = static_cast<std::ptrdiff_t>(size_of(self));
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return make_zip_iterator<Config, mask<Self>, props::counted>(
+                        (std::ranges::begin(range<Indices>(self)) +
+                         static_cast<std::ranges::range_difference_t<range_t<Self, Containers>>>(count))...);
+                }
+                (std::make_index_sequence<sizeof...(Containers)>{});
+            } else if constexpr (props::common) {
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    if constexpr (props::counted) {
+                        return make_counted_zip_iterator<Config, mask<Self>>(
+                            static_cast<std::ptrdiff_t>(size_of(self)), std::ranges::end(range<Indices>(self))...);
+                    } else {
+                        return make_zip_iterator<Config, mask<Self>, props::counted>(
+                            std::ranges::end(range<Indices>(self))...);
+                    }
+                }
+                (std::make_index_sequence<sizeof...(Containers)>{});
+            } else if constexpr (props::counted) {
+                return zip_sentinel<true, std::ranges::sentinel_t<range_t<Self, Containers>>...>(
+                    static_cast<std::ptrdiff_t>(size_of(self)));
+            } else {
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return zip_sentinel<false, std::ranges::sentinel_t<range_t<Self, Containers>>...>(
+                        std::ranges::end(range<Indices>(self))...);
+                }
+                (std::make_index_sequence<sizeof...(Containers)>{});
+            }
+        }
+
+        template <typename Self>
+        static constexpr std::size_t size_of(Self &self) noexcept(
+            (noexcept(bounded_size(std::declval<range_t<Self, Containers> &>())) && ...)) {
+            if constexpr (properties<Self>::extent != std::dynamic_extent) {
+                return properties<Self>::extent;
+            } else if constexpr (configuration::contains<Config, configuration::zip_config::EQUAL_LENGTHS>) {
+                constexpr std::size_t lead = utils::first_bounded<utils::unbounded_range<range_t<Self, Containers>>...>;
+                auto const size = bounded_size(range<lead>(self));
+                assert([&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return ((utils::unbounded_range<range_t<Self, Containers>> ||
+                             bounded_size(range<Indices>(self)) == size) &&
+                            ...);
+                }(std::make_index_sequence<sizeof...(Containers)>{}) &&
+                       "Inputs of an EQUAL_LENGTHS zip differ in length");
+                return size;
+            } else {
+                return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    return std::min({bounded_size(range<Indices>(self))...});
+                }
+                (std::make_index_sequence<sizeof...(Containers)>{});
+            }
+        }
+
+        template <std::size_t I, typename Self>
+        static constexpr auto row_of(Self &self) noexcept(
+            (noexcept(std::ranges::begin(std::declval<range_t<Self, Containers> &>())[I]) && ...)) {
             return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
-                return make_zip_iterator<Config, mask>(std::begin(std::get<Indices>(static_cast<base &>(*this)))...);
+                return zip_row<std::ranges::range_reference_t<range_t<Self, Containers>>...>(
+                    std::ranges::begin(range<Indices>(self))[I]...);
             }
             (std::make_index_sequence<sizeof...(Containers)>{});
         }
 
-        constexpr auto end() noexcept(requires(Containers... cons) {
-                                          { make_zip_iterator<Config, mask>(std::end(cons)...) } noexcept;
-                                      }) {
+        template <typename Self, typename Function>
+        static constexpr void for_each_of(Self &self, Function &function) {
+            if constexpr (extent <= max_unrolled_extent) {
+                [&]<std::size_t... Rows>(std::index_sequence<Rows...>) {
+                    ((void)[&] {
+                        auto row = row_of<Rows>(self);
+                        std::invoke(function, row);
+                    }(),
+                     ...);
+                }
+                (std::make_index_sequence<extent>{});
+            } else {
+                for (auto &&row : self) {
+                    std::invoke(function, row);
+                }
+            }
+        }
+
+        template <typename Self>
+        static constexpr auto spans_of(Self &self) noexcept(noexcept(size_of(self))) {
+            auto const count = size_of(self);
             return [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
-                return make_zip_iterator<Config, mask>(std::end(std::get<Indices>(static_cast<base &>(*this)))...);
+                return std::tuple{std::span(std::ranges::data(range<Indices>(self)), count)...};
             }
             (std::make_index_sequence<sizeof...(Containers)>{});
         }
+
+        template <typename Container>
+        static std::size_t probed_size(Container &container) {
+            if constexpr (utils::unbounded_range<Container>) {
+                return instrumentation::unbounded_size;
+            } else if constexpr (std::ranges::sized_range<Container>) {
+                return static_cast<std::size_t>(std::ranges::size(container));
+            } else {
+                return instrumentation::unknown_size;
+            }
+        }
+
+        template <typename Container>
+        static constexpr std::size_t bounded_size(Container &container) noexcept(
+            utils::unbounded_range<Container> || requires {
+                { std::ranges::size(container) } noexcept;
+            }) {
+            if constexpr (utils::unbounded_range<Container>) {
+                return std::numeric_limits<std::size_t>::max();
+            } else {
+                return static_cast<std::size_t>(std::ranges::size(container));
+            }
+        }
+
+        std::tuple<utils::stored_input<Containers>...> inputs_;
+        [[no_unique_address]] call_site site_;
     };
 
+
+    // Where zips of the configuration are created from, kept only when they are instrumented
+    template <configuration::zip_config Config>
+    using call_site_t =
+        instrumentation::call_site<configuration::contains<Config, configuration::zip_config::INSTRUMENT>>;
+
+    template <configuration::zip_config Config, std::ranges::input_range... Containers>
+    constexpr auto make_zip(call_site_t<Config> site, Containers &&...containers) noexcept(
+        utils::all_are_lvalues_or_nothrow_movable<Containers &&...>()) {
+        using impl = zip_impl<Config, utils::remove_rvalue_ref_t<Containers>...>;
+        return impl(site, std::forward<Containers>(containers)...);
+    }
+
 }  // namespace zip_utils::detail::impl
 
 
+namespace std::ranges {
+
+    // Iterators of a zip point into its inputs only: it is borrowed when it owns none or only borrowed ones
+    template <zip_utils::configuration::zip_config Config, typename... Containers>
+    inline constexpr bool enable_borrowed_range<zip_utils::detail::impl::zip_impl<Config, Containers...>> =
+        ((is_lvalue_reference_v<Containers> || enable_borrowed_range<remove_cvref_t<Containers>>) && ...);
+
+}  // namespace std::ranges
+
+
 namespace std {
 
-    template <zip_utils::configuration::zip_config Config, typename Mask, typename... Types>
-    struct tuple_size<zip_utils::detail::impl::zip_value<Config, Mask, Types...>> {
-        static constexpr std::size_t value = sizeof...(Types);
+    template <typename... Values>
+    struct tuple_size<zip_utils::detail::impl::zip_row<Values...>> {
+        static constexpr std::size_t value = sizeof...(Values);
+    };
+
+    template <std::size_t I, typename... Values>
+    struct tuple_element<I, zip_utils::detail::impl::zip_row<Values...>> {
+        using type = zip_utils::detail::utils::get_at<I, Values...>;
+    };
+
+    // Rows meet at a row of common references, as std::tuple does in C++23
+    template <typename... Lhs, typename... Rhs, template <typename> typename LhsQual,
+              template <typename> typename RhsQual>
+    requires(sizeof...(Lhs) == sizeof...(Rhs)) struct basic_common_reference<zip_utils::detail::impl::zip_row<Lhs...>,
+                                                                             zip_utils::detail::impl::zip_row<Rhs...>,
+                                                                             LhsQual, RhsQual> {
+        using type = zip_utils::detail::impl::zip_row<common_reference_t<LhsQual<Lhs>, RhsQual<Rhs>>...>;
     };
 
-    template <zip_utils::configuration::zip_config Config, std::size_t I, typename Mask, typename... Types>
-    struct tuple_element<I, zip_utils::detail::impl::zip_value<Config, Mask, Types...>> {
-        using iterator = zip_utils::detail::utils::get_at<I, Types...>;
-        using type = std::remove_reference_t<typename iterator_traits<iterator>::reference>;
+    // Fixed extent zips are tuples of their rows
+    template <zip_utils::configuration::zip_config Config, typename... Containers>
+    requires(zip_utils::detail::impl::zip_impl<Config, Containers...>::extent !=
+             std::dynamic_extent) struct tuple_size<zip_utils::detail::impl::zip_impl<Config, Containers...>> {
+        static constexpr std::size_t value = zip_utils::detail::impl::zip_impl<Config, Containers...>::extent;
     };
 
-    template <zip_utils::configuration::zip_config Config, std::size_t I, typename Mask, typename... Types>
-    struct tuple_element<I, zip_utils::detail::impl::zip_value<Config, Mask, Types...> const> {
-        using type = const tuple_element_t<I, zip_utils::detail::impl::zip_value<Config, Mask, Types...>>;
+    template <std::size_t I, zip_utils::configuration::zip_config Config, typename... Containers>
+    requires(zip_utils::detail::impl::zip_impl<Config, Containers...>::extent !=
+             std::dynamic_extent) struct tuple_element<I, zip_utils::detail::impl::zip_impl<Config, Containers...>> {
+        using type = decltype(std::declval<zip_utils::detail::impl::zip_impl<Config, Containers...> &>().template get<I>());
     };
 
 }  // namespace std
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace zip_utils::instrumentation {
+
+    // Totals of the instrumented zips created at one call site, such as the `zip` call of a range-for statement
+    struct site_stats {
+        std::string file;
+        std::string function;
+        std::uint_least32_t line = 0;
+        std::uint_least32_t column = 0;
+        std::size_t inputs = 0;
+
+        std::uint64_t iterations = 0;  // begin iterators done with, see probe
+        std::uint64_t completed = 0;   // iterations that reached the end of the zip
+        std::uint64_t rows = 0;
+        std::chrono::nanoseconds time{0};
+
+        // Iterations over inputs of different lengths, the number of times each input was the shortest one
+        // and the rows left over in the longer sized inputs
+        std::uint64_t mismatches = 0;
+        std::vector<std::uint64_t> ended_first;
+        std::uint64_t truncated_rows = 0;
+    };
+
+
+    class registry {
+       public:
+        // Every instrumented zip reports here
+        static registry &global() {
+            static registry instance;
+            return instance;
+        }
+
+        // Copies of the statistics of the sites iterated since the last reset, sorted by their call sites
+        [[nodiscard]] std::vector<site_stats> sites() const {
+            std::lock_guard lock(mutex_);
+            std::vector<site_stats> result;
+            for (auto const &[key, stats] : sites_) {
+                if (stats.iterations > 0) {
+                    result.push_back(stats);
+                }
+            }
+            return result;
+        }
+
+        // Zeroes the statistics, iterations in progress keep reporting to their sites
+        void reset() {
+            std::lock_guard lock(mutex_);
+            for (auto &[key, stats] : sites_) {
+                stats.iterations = stats.completed = stats.rows = stats.mismatches = stats.truncated_rows = 0;
+                stats.time = std::chrono::nanoseconds{0};
+                std::ranges::fill(stats.ended_first, 0);
+            }
+        }
+
+        void dump_json(std::ostream &out) const {
+            auto const all = sites();
+            out << "{\n  \"sites\": [";
+            for (std::size_t i = 0; i < all.size(); ++i) {
+                auto const &site = all[i];
+                out << (i == 0 ? "" : ",") << "\n    {\"file\": ";
+                write_string(out, site.file);
+                out << ", \"line\": " << site.line << ", \"column\": " << site.column << ", \"function\": ";
+                write_string(out, site.function);
+                out << ", \"inputs\": " << site.inputs << ", \"iterations\": " << site.iterations
+                    << ", \"completed\": " << site.completed << ", \"rows\": " << site.rows
+                    << ", \"time_ns\": " << site.time.count() << ", \"mismatches\": " << site.mismatches
+                    << ", \"ended_first\": [";
+                for (std::size_t j = 0; j < site.ended_first.size(); ++j) {
+                    out << (j == 0 ? "" : ", ") << site.ended_first[j];
+                }
+                out << "], \"truncated_rows\": " << site.truncated_rows << "}";
+            }
+            out << "\n  ]\n}\n";
+        }
+
+        // The statistics of a call site, they stay at the same address
+        site_stats &site(std::source_location const &location, std::size_t inputs) {
+            std::lock_guard lock(mutex_);
+            auto [it, inserted] = sites_.try_emplace(
+                key(std::string_view(location.file_name()), location.line(), location.column(),
+                    std::string_view(location.function_name()), inputs));
+            if (inserted) {
+                auto &stats = it->second;
+                stats.file = location.file_name();
+                stats.function = location.function_name();
+                stats.line = location.line();
+                stats.column = location.column();
+                stats.inputs = inputs;
+                stats.ended_first.resize(inputs);
+            }
+            return it->second;
+        }
+
+        // Statistics are updated under the registry lock, once per iteration
+        template <typename Update>
+        void update(site_stats &stats, Update &&update) {
+            std::lock_guard lock(mutex_);
+            std::forward<Update>(update)(stats);
+        }
+
+       private:
+        // The same line may hold zips of different arities, e.g. in a macro
+        using key = std::tuple<std::string_view, std::uint_least32_t, std::uint_least32_t, std::string_view, std::size_t>;
+
+        static void write_string(std::ostream &out, std::string_view text) {
+            out << '"';
+            for (char const c : text) {
+                if (c == '"' || c == '\\') {
+                    out << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    constexpr char digits[] = "0123456789abcdef";
+                    out << "\\u00" << digits[(c >> 4) & 0xF] << digits[c & 0xF];
+                } else {
+                    out << c;
+                }
+            }
+            out << '"';
+        }
+
+        mutable std::mutex mutex_;
+        std::map<key, site_stats> sites_;
+    };
+
+}  // namespace zip_utils::instrumentation
+
+
+namespace zip_utils::detail::instrumentation {
+
+    // The location a zip is created at, kept only by instrumented zips.
+    // std::source_location::current() as a default argument is evaluated at the caller.
+    template <bool Enabled>
+    struct call_site {
+        constexpr call_site() noexcept = default;
+        constexpr call_site(std::source_location) noexcept {}
+    };
+
+    template <>
+    struct call_site<true> {
+        constexpr call_site(std::source_location location) noexcept : location(location) {}
+
+        std::source_location location;
+    };
+
+    // Sizes of inputs that never end, and of inputs whose size is found only when the end is reached
+    inline constexpr std::size_t unbounded_size = std::numeric_limits<std::size_t>::max();
+    inline constexpr std::size_t unknown_size = unbounded_size - 1;
+
+
+    // Counts the rows of one iteration and reports it when its begin iterator is destroyed.
+    // Copies of a begin iterator do not report, moves take the report over.
+    template <std::size_t Inputs>
+    class probe {
+        using clock = std::chrono::steady_clock;
+
+       public:
+        constexpr probe() = default;
+
+        constexpr probe(probe const &) noexcept {}
+
+        constexpr probe(probe &&other) noexcept
+            : site_(std::exchange(other.site_, nullptr)),
+              rows_(other.rows_),
+              start_(other.start_),
+              sizes_(other.sizes_),
+              ended_(other.ended_),
+              completed_(other.completed_) {}
+
+        constexpr probe &operator=(probe const &) noexcept {
+            finish();
+            return *this;
+        }
+
+        constexpr probe &operator=(probe &&other) noexcept {
+            if (this != &other) {
+                finish();
+                site_ = std::exchange(other.site_, nullptr);
+                rows_ = other.rows_;
+                start_ = other.start_;
+                sizes_ = other.sizes_;
+                ended_ = other.ended_;
+                completed_ = other.completed_;
+            }
+            return *this;
+        }
+
+        constexpr ~probe() {
+            finish();
+        }
+
+        // Sizes of the inputs, or unbounded_size and unknown_size
+        void start(std::source_location const &location, std::array<std::size_t, Inputs> const &sizes) {
+            finish();
+            site_ = &zip_utils::instrumentation::registry::global().site(location, Inputs);
+            rows_ = 0;
+            sizes_ = sizes;
+            ended_ = {};
+            completed_ = false;
+            start_ = clock::now();
+        }
+
+        [[nodiscard]] constexpr bool active() const noexcept {
+            return site_ != nullptr;
+        }
+
+        constexpr void step(std::ptrdiff_t rows) noexcept {
+            rows_ += rows;
+        }
+
+        // The inputs whose ends are reached
+        constexpr void reach(std::array<bool, Inputs> const &ended) noexcept {
+            if (site_ != nullptr && !completed_) {
+                completed_ = true;
+                ended_ = ended;
+            }
+        }
+
+       private:
+        constexpr void finish() noexcept {
+            if (site_ == nullptr) {
+                return;
+            }
+            auto const time = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_);
+            auto const [first, truncated] = shortest();
+            auto *site = std::exchange(site_, nullptr);
+            zip_utils::instrumentation::registry::global().update(*site, [&](auto &stats) {
+                ++stats.iterations;
+                stats.completed += completed_;
+                stats.rows += static_cast<std::uint64_t>(std::max<std::ptrdiff_t>(rows_, 0));
+                stats.time += time;
+                if (first < Inputs) {
+                    ++stats.mismatches;
+                    ++stats.ended_first[first];
+                    stats.truncated_rows += truncated;
+                }
+            });
+        }
+
+        // The input that ended first when the lengths differ, and the rows left over in the longest sized input
+        std::pair<std::size_t, std::uint64_t> shortest() const noexcept {
+            constexpr auto none = std::pair<std::size_t, std::uint64_t>{Inputs, 0};
+            bool const known = std::ranges::find(sizes_, unknown_size) == sizes_.end();
+            if (!known && !completed_) {
+                // only an iteration that reached the end tells which inputs of unknown size ended
+                return none;
+            }
+
+            std::size_t first = Inputs;
+            std::size_t min = unbounded_size;
+            std::size_t max = 0;
+            bool all_ended = true;
+            for (std::size_t i = 0; i < Inputs; ++i) {
+                if (sizes_[i] == unbounded_size) {
+                    continue;
+                }
+                if (known) {
+                    first = sizes_[i] < min ? i : first;
+                    min = std::min(min, sizes_[i]);
+                } else {
+                    first = ended_[i] && first == Inputs ? i : first;
+                    all_ended = all_ended && ended_[i];
+                    min = static_cast<std::size_t>(rows_);
+                }
+                max = sizes_[i] == unknown_size ? max : std::max(max, sizes_[i]);
+            }
+            if (known ? min == max : all_ended) {
+                return none;
+            }
+            return {first, max > min ? max - min : 0};
+        }
+
+        zip_utils::instrumentation::site_stats *site_ = nullptr;
+        std::ptrdiff_t rows_ = 0;
+        clock::time_point start_{};
+        std::array<std::size_t, Inputs> sizes_{};
+        std::array<bool, Inputs> ended_{};
+        bool completed_ = false;
+    };
+
+}  // namespace zip_utils::detail::instrumentation
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "configuration.hpp"
+#include "impl.hpp"
+
+
+namespace zip_utils::detail::merge_join {
+
+    // Advances `it` past the leading elements for which `below` holds, the range being partitioned by it.
+    // Random access inputs are searched exponentially: skipping `d` elements takes about 2 log d comparisons.
+    template <typename Iterator, typename Sentinel, typename Below>
+    constexpr void skip_below(Iterator &it, Sentinel const &end, Below &&below) {
+        if constexpr (std::random_access_iterator<Iterator> && std::sized_sentinel_for<Sentinel, Iterator>) {
+            using difference_type = std::iter_difference_t<Iterator>;
+            difference_type const size = end - it;
+            if (size == 0 || !below(*it)) {
+                return;
+            }
+            difference_type bound = 2;
+            while (bound <= size && below(it[bound - 1])) {
+                bound *= 2;
+            }
+            it = std::ranges::partition_point(it + bound / 2, it + std::min(bound - 1, size), below);
+        } else {
+            while (it != end && below(*it)) {
+                ++it;
+            }
+        }
+    }
+
+
+    // Component of a left outer row: a pointer to the matching element, or a null one.
+    // Elements read as prvalues are returned as optionals instead.
+    template <std::forward_iterator Iterator>
+    class optional_iterator {
+        static constexpr bool addressable = std::is_lvalue_reference_v<std::iter_reference_t<Iterator>>;
+
+       public:
+        using value_type = std::conditional_t<addressable, std::add_pointer_t<std::iter_reference_t<Iterator>>,
+                                              std::optional<std::iter_value_t<Iterator>>>;
+        using difference_type = std::iter_difference_t<Iterator>;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr optional_iterator() = default;
+
+        constexpr optional_iterator(Iterator it, bool present) noexcept(std::is_nothrow_move_constructible_v<Iterator>)
+            : it_(std::move(it)), present_(present) {}
+
+        constexpr value_type operator*() const {
+            if (!present_) {
+                return value_type{};
+            } else if constexpr (addressable) {
+                return std::addressof(*it_);
+            } else {
+                return value_type(*it_);
+            }
+        }
+
+        constexpr optional_iterator &operator++() {
+            ++it_;
+            return *this;
+        }
+
+        constexpr optional_iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        constexpr bool operator==(optional_iterator const &other) const = default;
+
+       private:
+        Iterator it_{};
+        bool present_ = false;
+    };
+
+
+    // Keys of elements read as prvalues are copied, a projection would return references into the temporaries
+    template <typename Key, typename Iterator>
+    using key_t = std::conditional_t<std::is_lvalue_reference_v<std::iter_reference_t<Iterator>>,
+                                     std::indirect_result_t<Key &, Iterator>,
+                                     std::remove_cvref_t<std::indirect_result_t<Key &, Iterator>>>;
+
+
+    template <typename LeftKey, typename RightKey>
+    struct join_keys {
+        [[no_unique_address]] LeftKey left;
+        [[no_unique_address]] RightKey right;
+    };
+
+
+    // Walks both sorted inputs once, rows are tuples of references to the matching elements.
+    // Equal keys on both sides give every combination of their elements, left major.
+    template <configuration::join_kind Kind, typename Left, typename Right, typename LeftKey, typename RightKey>
+    class merge_join_iterator {
+        using left_iterator = std::ranges::iterator_t<Left>;
+        using left_sentinel = std::ranges::sentinel_t<Left>;
+        using right_iterator = std::ranges::iterator_t<Right>;
+        using right_sentinel = std::ranges::sentinel_t<Right>;
+
+        static constexpr bool outer = Kind == configuration::join_kind::LEFT_OUTER;
+
+        using right_component = std::conditional_t<outer, optional_iterator<right_iterator>, right_iterator>;
+
+       public:
+        using value_type = impl::zip_row<std::iter_value_t<left_iterator>, std::iter_value_t<right_component>>;
+        using reference = impl::zip_row<std::iter_reference_t<left_iterator>, std::iter_reference_t<right_component>>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr merge_join_iterator() = default;
+
+        constexpr merge_join_iterator(left_iterator left, left_sentinel left_end, right_iterator right,
+                                      right_sentinel right_end, join_keys<LeftKey, RightKey> *keys)
+            : left_(std::move(left)),
+              left_end_(std::move(left_end)),
+              right_(std::move(right)),
+              right_end_(std::move(right_end)),
+              keys_(keys) {
+            if constexpr (outer) {
+                settle();
+            } else {
+                find_match();
+            }
+        }
+
+        // Rows are returned by value, like the rows of a zip
+        constexpr reference operator*() const {
+            if constexpr (outer) {
+                return reference(*left_, *right_component(right_, matched_));
+            } else {
+                return reference(*left_, *right_);
+            }
+        }
+
+        constexpr merge_join_iterator &operator++() {
+            if constexpr (outer) {
+                if (matched_ && ++right_ != right_end_ && !less(left_key(), right_key())) {
+                    return *this;
+                }
+                if (++left_ != left_end_ && matched_ && !less(run_key(), left_key())) {
+                    right_ = run_;
+                    return *this;
+                }
+                settle();
+            } else {
+                if (++right_ != right_end_ && !less(left_key(), right_key())) {
+                    return *this;
+                }
+                if (++left_ != left_end_ && !less(run_key(), left_key())) {
+                    right_ = run_;
+                    return *this;
+                }
+                find_match();
+            }
+            return *this;
+        }
+
+        constexpr merge_join_iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        constexpr bool operator==(merge_join_iterator const &other) const {
+            return left_ == other.left_ && right_ == other.right_;
+        }
+
+        constexpr bool operator==(std::default_sentinel_t) const {
+            if constexpr (outer) {
+                return left_ == left_end_;
+            } else {
+                return left_ == left_end_ || right_ == right_end_;
+            }
+        }
+
+       private:
+        static constexpr bool less(auto const &lhs, auto const &rhs) {
+            return std::ranges::less{}(lhs, rhs);
+        }
+
+        constexpr key_t<LeftKey, left_iterator> left_key() const {
+            return std::invoke(keys_->left, *left_);
+        }
+
+        constexpr key_t<RightKey, right_iterator> right_key() const {
+            return std::invoke(keys_->right, *right_);
+        }
+
+        constexpr key_t<RightKey, right_iterator> run_key() const {
+            return std::invoke(keys_->right, *run_);
+        }
+
+        // Inner join: advances the side with the smaller key until the keys are equal or an input ends
+        constexpr void find_match() {
+            while (left_ != left_end_ && right_ != right_end_) {
+                auto &&left = left_key();
+                auto &&right = right_key();
+                if (less(left, right)) {
+                    skip_below(++left_, left_end_,
+                               [&](auto &&element) { return less(std::invoke(keys_->left, element), right); });
+                } else if (less(right, left)) {
+                    skip_below(++right_, right_end_,
+                               [&](auto &&element) { return less(std::invoke(keys_->right, element), left); });
+                } else {
+                    run_ = right_;
+                    return;
+                }
+            }
+        }
+
+        // Left outer join: finds the first right key not below the key of a new left row
+        constexpr void settle() {
+            if (left_ == left_end_) {
+                return;
+            }
+            auto &&key = left_key();
+            skip_below(right_, right_end_, [&](auto &&element) { return less(std::invoke(keys_->right, element), key); });
+            run_ = right_;
+            matched_ = right_ != right_end_ && !less(key, right_key());
+        }
+
+        left_iterator left_{};
+        [[no_unique_address]] left_sentinel left_end_{};
+        right_iterator right_{};
+        right_iterator run_{};  // first right element with the current key
+        [[no_unique_address]] right_sentinel right_end_{};
+        bool matched_ = false;
+        join_keys<LeftKey, RightKey> *keys_ = nullptr;
+    };
+
+
+    template <configuration::join_kind Kind, std::ranges::forward_range Left, std::ranges::forward_range Right,
+              typename LeftKey, typename RightKey>
+    class merge_join_view {
+       public:
+        template <typename LeftInput, typename RightInput>
+        constexpr merge_join_view(LeftInput &&left, RightInput &&right, LeftKey left_key, RightKey right_key)
+            : left_(std::forward<LeftInput>(left)),
+              right_(std::forward<RightInput>(right)),
+              keys_{std::move(left_key), std::move(right_key)} {}
+
+        // Rows are searched for eagerly, so the first one is found here
+        constexpr auto begin() {
+            return merge_join_iterator<Kind, std::remove_reference_t<Left>, std::remove_reference_t<Right>, LeftKey,
+                                       RightKey>(std::ranges::begin(left_), std::ranges::end(left_),
+                                                 std::ranges::begin(right_), std::ranges::end(right_), &keys_);
+        }
+
+        constexpr std::default_sentinel_t end() const noexcept {
+            return std::default_sentinel;
+        }
+
+       private:
+        Left left_;
+        Right right_;
+        join_keys<LeftKey, RightKey> keys_;
+    };
+
+}  // namespace zip_utils::detail::merge_join
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "utils.hpp"
+
+
+namespace zip_utils::detail::prefetch {
+
+    // Node-based inputs: elements are not found by address arithmetic, so they are worth touching early
+    template <typename Iterator>
+    concept prefetchable = std::forward_iterator<Iterator> && !std::random_access_iterator<Iterator> &&
+                           std::is_lvalue_reference_v<std::iter_reference_t<Iterator>> && requires(Iterator it) {
+        { ++it } noexcept;
+    };
+
+    inline void touch(void const *address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address, 0, 3);
+#else
+        (void)address;
+#endif
+    }
+
+    // Cursors running `distance` rows ahead of the zip, one per prefetchable input. They only move forward
+    // and never past the zip size, so moving the zip backwards or jumping just makes the hints stale.
+    template <typename... Iterators>
+    class lookahead {
+       public:
+        static constexpr bool enabled = (prefetchable<Iterators> || ...);
+
+        constexpr lookahead() = default;
+
+        lookahead(std::ptrdiff_t distance, std::ptrdiff_t size, Iterators const &...firsts) noexcept(
+            (std::is_nothrow_copy_constructible_v<Iterators> && ...))
+            : cursors_(cursor_of(firsts)...) {
+            auto const lead = std::min(distance, size);
+            for (std::ptrdiff_t i = 0; i < lead; ++i) {
+                advance();
+            }
+            left_ = size - lead;
+        }
+
+        void step() noexcept {
+            if (left_ > 0) {
+                [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                    (touch_cursor<Indices>(), ...);
+                }
+                (std::index_sequence_for<Iterators...>{});
+                advance();
+                --left_;
+            }
+        }
+
+       private:
+        template <typename Iterator>
+        static auto cursor_of(Iterator const &first) noexcept(std::is_nothrow_copy_constructible_v<Iterator>) {
+            if constexpr (prefetchable<Iterator>) {
+                return first;
+            } else {
+                return utils::empty{};
+            }
+        }
+
+        template <std::size_t I>
+        void touch_cursor() noexcept {
+            if constexpr (prefetchable<utils::get_at<I, Iterators...>>) {
+                touch(std::addressof(*std::get<I>(cursors_)));
+            }
+        }
+
+        template <std::size_t I>
+        void advance_cursor() noexcept {
+            if constexpr (prefetchable<utils::get_at<I, Iterators...>>) {
+                ++std::get<I>(cursors_);
+            }
+        }
+
+        void advance() noexcept {
+            [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                (advance_cursor<Indices>(), ...);
+            }
+            (std::index_sequence_for<Iterators...>{});
+        }
+
+        std::tuple<std::conditional_t<prefetchable<Iterators>, Iterators, utils::empty>...> cursors_{};
+        std::ptrdiff_t left_ = 0;
+    };
+
+}  // namespace zip_utils::detail::prefetch
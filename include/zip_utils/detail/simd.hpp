@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace zip_utils::detail::simd {
+
+    // `baseline` is whatever the translation unit is compiled for: SSE2 on x86-64, scalar code elsewhere
+    enum class instruction_set { baseline, avx2, avx512 };
+
+#if defined(__GNUC__)
+#define ZIP_UTILS_SIMD_INLINE [[gnu::always_inline]] inline
+#else
+#define ZIP_UTILS_SIMD_INLINE inline
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZIP_UTILS_SIMD_DISPATCH
+
+    inline instruction_set detected_instruction_set() noexcept {
+        static instruction_set const detected = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return instruction_set::avx512;
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                return instruction_set::avx2;
+            }
+            return instruction_set::baseline;
+        }();
+        return detected;
+    }
+
+#else
+
+    inline instruction_set detected_instruction_set() noexcept {
+        return instruction_set::baseline;
+    }
+
+#endif
+
+
+    // Loop bodies are inlined into kernels compiled for every instruction set, which vectorize them to its width.
+    // Sums are kept in `Lanes` independent accumulators, so they reassociate like std::reduce.
+
+    template <std::size_t Lanes, typename T, typename Transform, typename... Values>
+    ZIP_UTILS_SIMD_INLINE T transform_reduce_body(std::size_t size, T init, Transform &transform,
+                                                          Values const *...columns) {
+        T lanes[Lanes] = {};
+        std::size_t i = 0;
+        for (; i + Lanes <= size; i += Lanes) {
+            for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                lanes[lane] += static_cast<T>(transform(columns[i + lane]...));
+            }
+        }
+        for (; i < size; ++i) {
+            lanes[i % Lanes] += static_cast<T>(transform(columns[i]...));
+        }
+        for (auto lane : lanes) {
+            init += lane;
+        }
+        return init;
+    }
+
+    template <typename Out, typename Function, typename... Values>
+    ZIP_UTILS_SIMD_INLINE void transform_body(std::size_t size, Out *out, Function &function,
+                                                      Values const *...columns) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = static_cast<Out>(function(columns[i]...));
+        }
+    }
+
+
+    // Two vector registers of accumulators hide the latency of the additions
+    template <typename T>
+    inline constexpr std::size_t lanes(std::size_t register_bytes) {
+        return 2 * (register_bytes / sizeof(T) > 0 ? register_bytes / sizeof(T) : 1);
+    }
+
+#if defined(ZIP_UTILS_SIMD_DISPATCH)
+
+    template <typename T, typename Transform, typename... Values>
+    [[gnu::target("avx512f")]] T transform_reduce_avx512(std::size_t size, T init, Transform &transform,
+                                                         Values const *...columns) {
+        return transform_reduce_body<lanes<T>(64)>(size, init, transform, columns...);
+    }
+
+    template <typename T, typename Transform, typename... Values>
+    [[gnu::target("avx2,fma")]] T transform_reduce_avx2(std::size_t size, T init, Transform &transform,
+                                                        Values const *...columns) {
+        return transform_reduce_body<lanes<T>(32)>(size, init, transform, columns...);
+    }
+
+    template <typename Out, typename Function, typename... Values>
+    [[gnu::target("avx512f")]] void transform_avx512(std::size_t size, Out *out, Function &function,
+                                                     Values const *...columns) {
+        transform_body(size, out, function, columns...);
+    }
+
+    template <typename Out, typename Function, typename... Values>
+    [[gnu::target("avx2,fma")]] void transform_avx2(std::size_t size, Out *out, Function &function,
+                                                    Values const *...columns) {
+        transform_body(size, out, function, columns...);
+    }
+
+#endif
+
+
+    template <typename T, typename Transform, typename... Values>
+    T transform_reduce(instruction_set set, std::size_t size, T init, Transform &transform, Values const *...columns) {
+#if defined(ZIP_UTILS_SIMD_DISPATCH)
+        switch (set) {
+            case instruction_set::avx512:
+                return transform_reduce_avx512(size, init, transform, columns...);
+            case instruction_set::avx2:
+                return transform_reduce_avx2(size, init, transform, columns...);
+            case instruction_set::baseline:
+                break;
+        }
+#else
+        (void)set;
+#endif
+        return transform_reduce_body<lanes<T>(16)>(size, init, transform, columns...);
+    }
+
+    template <typename Out, typename Function, typename... Values>
+    void transform(instruction_set set, std::size_t size, Out *out, Function &function, Values const *...columns) {
+#if defined(ZIP_UTILS_SIMD_DISPATCH)
+        switch (set) {
+            case instruction_set::avx512:
+                return transform_avx512(size, out, function, columns...);
+            case instruction_set::avx2:
+                return transform_avx2(size, out, function, columns...);
+            case instruction_set::baseline:
+                break;
+        }
+#else
+        (void)set;
+#endif
+        transform_body(size, out, function, columns...);
+    }
+
+}  // namespace zip_utils::detail::simd
+
+#undef ZIP_UTILS_SIMD_INLINE
+#undef ZIP_UTILS_SIMD_DISPATCH
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+
+namespace zip_utils::detail::pool {
+
+    // Chunk indices owned by one participant: the owner pops from the front, thieves take the back half
+    class chunk_queue {
+       public:
+        void reset(std::size_t first, std::size_t last) {
+            std::lock_guard lock(mutex_);
+            first_ = first;
+            last_ = last;
+        }
+
+        std::optional<std::size_t> pop() {
+            std::lock_guard lock(mutex_);
+            if (first_ == last_) {
+                return std::nullopt;
+            }
+            return first_++;
+        }
+
+        bool steal_into(chunk_queue &thief) {
+            std::size_t first, last;
+            {
+                std::lock_guard lock(mutex_);
+                if (first_ == last_) {
+                    return false;
+                }
+                first = last_ - (last_ - first_ + 1) / 2;
+                last = last_;
+                last_ = first;
+            }
+            thief.reset(first, last);
+            return true;
+        }
+
+       private:
+        std::mutex mutex_;
+        std::size_t first_ = 0;
+        std::size_t last_ = 0;
+    };
+
+
+    class thread_pool {
+       public:
+        explicit thread_pool(std::size_t workers) : queues_(workers + 1) {
+            workers_.reserve(workers);
+            for (std::size_t index = 0; index < workers; ++index) {
+                workers_.emplace_back([this, index] { worker_main(index + 1); });
+            }
+        }
+
+        thread_pool(thread_pool const &) = delete;
+        thread_pool &operator=(thread_pool const &) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto &worker : workers_) {
+                worker.join();
+            }
+        }
+
+        // Process-wide pool with a worker per hardware thread, the calling thread being one of them
+        static thread_pool &instance() {
+            static thread_pool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+            return pool;
+        }
+
+        [[nodiscard]] std::size_t concurrency() const noexcept {
+            return workers_.size() + 1;
+        }
+
+        // Calls task(chunk) for every chunk in [0, chunks) on up to `participants` threads, including the caller.
+        // Nested calls from inside a task run serially. The first exception thrown by a task is rethrown.
+        template <typename Task>
+        void run(std::size_t chunks, std::size_t participants, Task &task) {
+            participants = std::min({participants, concurrency(), chunks});
+            if (participants <= 1 || inside_) {
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                    task(chunk);
+                }
+                return;
+            }
+
+            std::lock_guard submit(submit_mutex_);
+            for (std::size_t participant = 0; participant < participants; ++participant) {
+                queues_[participant].reset(chunks * participant / participants,
+                                           chunks * (participant + 1) / participants);
+            }
+            {
+                std::lock_guard lock(mutex_);
+                invoke_ = [](void *erased, std::size_t chunk) { (*static_cast<Task *>(erased))(chunk); };
+                task_ = &task;
+                participants_ = participants;
+                finished_ = 0;
+                error_ = nullptr;
+                failed_.store(false, std::memory_order_relaxed);
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            work(0);
+
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [&] { return finished_ == participants_ - 1; });
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+        }
+
+       private:
+        void worker_main(std::size_t participant) {
+            std::size_t seen = 0;
+            std::unique_lock lock(mutex_);
+            while (true) {
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                if (participant >= participants_) {
+                    continue;
+                }
+
+                lock.unlock();
+                work(participant);
+                lock.lock();
+
+                if (++finished_ == participants_ - 1) {
+                    done_.notify_one();
+                }
+            }
+        }
+
+        void work(std::size_t participant) {
+            inside_ = true;
+            while (true) {
+                while (auto chunk = queues_[participant].pop()) {
+                    execute(*chunk);
+                }
+
+                bool stolen = false;
+                for (std::size_t offset = 1; offset < participants_ && !stolen; ++offset) {
+                    stolen = queues_[(participant + offset) % participants_].steal_into(queues_[participant]);
+                }
+                if (!stolen) {
+                    break;
+                }
+            }
+            inside_ = false;
+        }
+
+        void execute(std::size_t chunk) {
+            if (failed_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            try {
+                invoke_(task_, chunk);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                failed_.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        static inline thread_local bool inside_ = false;
+
+        std::mutex submit_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        std::size_t generation_ = 0;
+        std::size_t participants_ = 0;
+        std::size_t finished_ = 0;
+        bool stop_ = false;
+
+        void (*invoke_)(void *, std::size_t) = nullptr;
+        void *task_ = nullptr;
+        std::exception_ptr error_;
+        std::atomic<bool> failed_ = false;
+
+        std::vector<chunk_queue> queues_;
+        std::vector<std::thread> workers_;
+    };
+
+}  // namespace zip_utils::detail::pool
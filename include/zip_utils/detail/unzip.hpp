@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace zip_utils::detail::unzip {
+
+    // Rows are zip rows (with their own `get`) or anything tuple-like
+    template <std::size_t I, typename Row>
+    constexpr decltype(auto) element(Row &&row) {
+        if constexpr (requires { std::forward<Row>(row).template get<I>(); }) {
+            return std::forward<Row>(row).template get<I>();
+        } else {
+            using std::get;
+            return get<I>(std::forward<Row>(row));
+        }
+    }
+
+    template <typename Row>
+    inline constexpr std::size_t columns = std::tuple_size_v<std::remove_cvref_t<Row>>;
+
+    // Rvalue containers own their elements. Views and zips do not: zips return rows by value and move by their
+    // own configuration.
+    template <typename Range>
+    inline constexpr bool owns_elements =
+        !std::is_lvalue_reference_v<Range> && !std::ranges::view<std::remove_cvref_t<Range>> &&
+        std::is_reference_v<std::ranges::range_reference_t<Range>>;
+
+    template <typename Container>
+    constexpr void reserve(Container &container, std::size_t rows) {
+        if constexpr (requires { container.reserve(rows); }) {
+            container.reserve(std::ranges::size(container) + rows);
+        }
+    }
+
+    template <typename Container, typename Value>
+    constexpr void append(Container &container, Value &&value) {
+        if constexpr (requires { container.push_back(std::forward<Value>(value)); }) {
+            container.push_back(std::forward<Value>(value));
+        } else {
+            container.insert(std::ranges::end(container), std::forward<Value>(value));
+        }
+    }
+
+    // Output iterator appending every column of the assigned rows to its own container.
+    // Elements of rvalue rows are moved, elements of lvalue rows are copied unless `Move` is set.
+    template <bool Move, typename... Containers>
+    class zip_insert_iterator {
+       public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        constexpr zip_insert_iterator() = default;
+
+        explicit constexpr zip_insert_iterator(Containers &...containers) noexcept
+            : containers_(std::addressof(containers)...) {}
+
+        template <typename Row>
+        requires(columns<Row> == sizeof...(Containers)) constexpr zip_insert_iterator &operator=(Row &&row) {
+            [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+                (insert<Indices>(std::forward<Row>(row)), ...);
+            }
+            (std::index_sequence_for<Containers...>{});
+            return *this;
+        }
+
+        // Reserves room for `rows` more rows in every container that can reserve
+        constexpr void reserve(std::size_t rows) {
+            std::apply([&](auto *...containers) { (unzip::reserve(*containers, rows), ...); }, containers_);
+        }
+
+        constexpr zip_insert_iterator &operator*() noexcept {
+            return *this;
+        }
+
+        constexpr zip_insert_iterator &operator++() noexcept {
+            return *this;
+        }
+
+        constexpr zip_insert_iterator &operator++(int) noexcept {
+            return *this;
+        }
+
+       private:
+        // Every element is taken from the row once, so forwarding the row for each of them is safe
+        template <std::size_t I, typename Row>
+        constexpr void insert(Row &&row) {
+            decltype(auto) value = element<I>(std::forward<Row>(row));
+            using value_type = decltype(value);
+            if constexpr (Move && std::is_lvalue_reference_v<value_type> &&
+                          !std::is_const_v<std::remove_reference_t<value_type>>) {
+                append(*std::get<I>(containers_), std::move(value));
+            } else {
+                append(*std::get<I>(containers_), std::forward<value_type>(value));
+            }
+        }
+
+        std::tuple<Containers *...> containers_{};
+    };
+
+}  // namespace zip_utils::detail::unzip
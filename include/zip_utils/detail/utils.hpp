@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <tuple>
 #include <type_traits>
 
@@ -10,17 +15,12 @@ namespace zip_utils::detail::utils {
     template <bool... Values>
     struct bool_mask {};
 
-    template <std::size_t I, bool Value, bool... Values>
-    constexpr bool mask_element_impl(bool_mask<Value, Values...>) {
-        if constexpr (I == 0) {
-            return Value;
-        } else {
-            return mask_element_impl<I - 1, Values...>({});
-        }
-    }
-
     template <std::size_t I, typename Mask>
-    constexpr bool mask_element = mask_element_impl<I>(Mask{});
+    constexpr bool mask_element = false;
+
+    // A single array lookup instead of one instantiation per skipped element
+    template <std::size_t I, bool... Values>
+    constexpr bool mask_element<I, bool_mask<Values...>> = std::array<bool, sizeof...(Values)>{Values...}[I];
 
     template <typename... Types>
     using types_to_rvalues_mask = bool_mask<std::is_rvalue_reference_v<Types>...>;
@@ -50,7 +50,149 @@ namespace zip_utils::detail::utils {
     static_assert(std::is_same_v<int, remove_rvalue_ref_t<const int &&>>);
     static_assert(std::is_same_v<int, remove_rvalue_ref_t<int &&>>);
 
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define ZIP_UTILS_HAS_TYPE_PACK_ELEMENT
+#endif
+#endif
+
+#ifdef ZIP_UTILS_HAS_TYPE_PACK_ELEMENT
+    template <std::size_t I, typename... Types>
+    using get_at = __type_pack_element<I, Types...>;
+#else
+    // Every type of the pack becomes a base tagged with its index, overload resolution picks the I-th one
+    template <std::size_t I, typename Type>
+    struct indexed_type {
+        using type = Type;
+    };
+
+    template <typename Indices, typename... Types>
+    struct indexed_types;
+
+    template <std::size_t... Indices, typename... Types>
+    struct indexed_types<std::index_sequence<Indices...>, Types...> : indexed_type<Indices, Types>... {};
+
+    template <std::size_t I, typename Type>
+    indexed_type<I, Type> select_indexed(indexed_type<I, Type> const &);
+
     template <std::size_t I, typename... Types>
-    using get_at = std::tuple_element_t<I, std::tuple<Types...>>;
+    using get_at = typename decltype(select_indexed<I>(
+        std::declval<indexed_types<std::index_sequence_for<Types...>, Types...>>()))::type;
+#endif
+
+#undef ZIP_UTILS_HAS_TYPE_PACK_ELEMENT
+
+    static_assert(std::is_same_v<char &, get_at<1, int, char &, long>>);
+
+    struct empty {};
+
+    // Empty members of one class overlap only when their types differ
+    template <std::size_t Slot>
+    struct empty_slot {};
+
+    // An input of a zip as std::views::all keeps it: an lvalue by address, so copies are cheap and assignments
+    // rebind, an rvalue by value. Owned inputs are copied only when they are views themselves.
+    template <typename Container>
+    class stored_input {
+       public:
+        template <typename Input>
+        explicit constexpr stored_input(Input &&input) noexcept(std::is_nothrow_constructible_v<Container, Input &&>)
+            : input_(std::forward<Input>(input)) {}
+
+        constexpr stored_input(stored_input const &) requires std::ranges::view<Container> = default;
+        constexpr stored_input(stored_input &&) = default;
+        constexpr stored_input &operator=(stored_input const &) requires std::ranges::view<Container> = default;
+        constexpr stored_input &operator=(stored_input &&) = default;
+
+        constexpr Container &get() noexcept {
+            return input_;
+        }
+
+        constexpr Container const &get() const noexcept {
+            return input_;
+        }
+
+       private:
+        Container input_;
+    };
+
+    template <typename Container>
+    class stored_input<Container &> {
+       public:
+        explicit constexpr stored_input(Container &input) noexcept : input_(std::addressof(input)) {}
+
+        constexpr Container &get() const noexcept {
+            return *input_;
+        }
+
+       private:
+        Container *input_;
+    };
+
+    // `range | adaptor` passes the range to the function, as the range adaptor closures of std::views do
+    template <typename Function>
+    struct range_adaptor {
+        template <std::ranges::input_range Range>
+        friend constexpr auto operator|(Range &&range, range_adaptor const &adaptor) noexcept(
+            std::is_nothrow_invocable_v<Function const &, Range &&>) -> std::invoke_result_t<Function const &, Range &&> {
+            return adaptor.function(std::forward<Range>(range));
+        }
+
+        [[no_unique_address]] Function function;
+    };
+
+    // Contiguous iterators are reported as random access: a zip of them is not contiguous itself
+    template <typename Iterator>
+    using iterator_concept_tag =
+        std::conditional_t<std::random_access_iterator<Iterator>, std::random_access_iterator_tag,
+                           std::conditional_t<std::bidirectional_iterator<Iterator>, std::bidirectional_iterator_tag,
+                                              std::conditional_t<std::forward_iterator<Iterator>,
+                                                                 std::forward_iterator_tag, std::input_iterator_tag>>>;
+
+    template <typename Range>
+    concept unbounded_range = std::same_as<std::ranges::sentinel_t<Range>, std::unreachable_sentinel_t>;
+
+    // The first input that may end, the lead one of an EQUAL_LENGTHS zip
+    template <bool... Unbounded>
+    constexpr std::size_t first_bounded = [] {
+        constexpr std::array<bool, sizeof...(Unbounded)> unbounded = {Unbounded...};
+        for (std::size_t i = 0; i < unbounded.size(); ++i) {
+            if (!unbounded[i]) {
+                return i;
+            }
+        }
+        return std::size_t{0};
+    }();
+
+    static_assert(first_bounded<true, false, false> == 1);
+
+    // Number of elements known from the type: built-in arrays, std::array and fixed std::span
+    template <typename Range>
+    constexpr std::size_t static_extent_of = std::dynamic_extent;
+
+    template <typename Type, std::size_t N>
+    constexpr std::size_t static_extent_of<Type[N]> = N;
+
+    template <typename Type, std::size_t N>
+    constexpr std::size_t static_extent_of<std::array<Type, N>> = N;
+
+    template <typename Type, std::size_t N>
+    constexpr std::size_t static_extent_of<std::span<Type, N>> = N;
+
+    template <typename Range>
+    constexpr std::size_t static_extent = static_extent_of<std::remove_cvref_t<Range>>;
+
+    // Iterators reached from a first position by one cheap addition: contiguous ones and those enabled here
+    template <typename Iterator>
+    constexpr bool enable_offset_addressing = std::contiguous_iterator<Iterator>;
+
+    template <typename Iterator>
+    concept offset_addressable = std::random_access_iterator<Iterator> && enable_offset_addressing<Iterator>;
+
+    // Iterator tags form a hierarchy, so their common type is the weakest one
+    template <typename... Iterators>
+    using weakest_iterator_tag = std::common_type_t<iterator_concept_tag<Iterators>...>;
+
+    static_assert(std::is_same_v<std::random_access_iterator_tag, weakest_iterator_tag<int *, char *>>);
 
 }  // namespace zip_utils::detail::utils
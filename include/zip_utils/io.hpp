@@ -0,0 +1,211 @@
+#pragma once
+
+#if !__has_include(<sys/mman.h>)
+#error "zip_utils/io.hpp requires POSIX mmap"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+
+namespace zip_utils::io {
+
+    enum class access {
+        read_only,
+        read_write,  // writes go to the file, see mapped_column::flush
+    };
+
+    struct options {
+        bool sequential = true;  // MADV_SEQUENTIAL: aggressive read-ahead, pages behind are dropped early
+        bool willneed = false;   // MADV_WILLNEED: starts reading the whole file in the background
+    };
+
+}  // namespace zip_utils::io
+
+
+namespace zip_utils::detail::io {
+
+    [[noreturn]] inline void throw_errno(std::string const &what, std::filesystem::path const &path) {
+        throw std::system_error(errno, std::generic_category(), what + " " + path.string());
+    }
+
+    class file_descriptor {
+       public:
+        // `mode` sets the permissions of a file created by O_CREAT, before the umask
+        file_descriptor(std::filesystem::path const &path, int flags, mode_t mode = 0)
+            : fd_(::open(path.c_str(), flags | O_CLOEXEC, mode)) {
+            if (fd_ < 0) {
+                throw_errno("Can not open", path);
+            }
+        }
+
+        file_descriptor(file_descriptor const &) = delete;
+        file_descriptor &operator=(file_descriptor const &) = delete;
+
+        ~file_descriptor() {
+            ::close(fd_);
+        }
+
+        [[nodiscard]] int get() const noexcept {
+            return fd_;
+        }
+
+       private:
+        int fd_;
+    };
+
+}  // namespace zip_utils::detail::io
+
+
+namespace zip_utils::io {
+
+    // A contiguous sized range over a flat binary file of `T`s, mapped into memory instead of read.
+    // The descriptor is closed after mapping, the mapping lives as long as the column.
+    template <typename T, access Mode = access::read_only>
+    requires std::is_trivially_copyable_v<T>
+    class mapped_column {
+       public:
+        using element_type = std::conditional_t<Mode == access::read_only, T const, T>;
+        using value_type = T;
+        using iterator = element_type *;
+
+        mapped_column() = default;
+
+        explicit mapped_column(std::filesystem::path const &path, options opts = {}) {
+            detail::io::file_descriptor file(path, Mode == access::read_only ? O_RDONLY : O_RDWR);
+
+            struct stat info {};
+            if (::fstat(file.get(), &info) != 0) {
+                detail::io::throw_errno("Can not stat", path);
+            }
+            auto const bytes = static_cast<std::size_t>(info.st_size);
+            if (bytes % sizeof(T) != 0) {
+                throw std::invalid_argument("File size is not a multiple of the element size: " + path.string());
+            }
+            map(file.get(), bytes, path);
+            advise(opts);
+        }
+
+        // Creates (or truncates) a file of `count` zero elements and maps it for writing
+        static mapped_column create(std::filesystem::path const &path, std::size_t count, options opts = {})
+            requires(Mode == access::read_write) {
+            {
+                detail::io::file_descriptor file(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (::ftruncate(file.get(), static_cast<off_t>(count * sizeof(T))) != 0) {
+                    detail::io::throw_errno("Can not resize", path);
+                }
+            }
+            return mapped_column(path, opts);
+        }
+
+        mapped_column(mapped_column &&other) noexcept
+            : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+        mapped_column &operator=(mapped_column &&other) noexcept {
+            if (this != &other) {
+                unmap();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        mapped_column(mapped_column const &) = delete;
+        mapped_column &operator=(mapped_column const &) = delete;
+
+        ~mapped_column() {
+            unmap();
+        }
+
+        [[nodiscard]] element_type *data() const noexcept {
+            return data_;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] iterator begin() const noexcept {
+            return data_;
+        }
+
+        [[nodiscard]] iterator end() const noexcept {
+            return data_ + size_;
+        }
+
+        [[nodiscard]] element_type &operator[](std::size_t i) const noexcept {
+            return data_[i];
+        }
+
+        // Hints the kernel about the coming access pattern, hints are best effort and never fail
+        void advise(options opts) const noexcept {
+            if (size_ == 0) {
+                return;
+            }
+            if (opts.sequential) {
+                ::madvise(mapping(), bytes(), MADV_SEQUENTIAL);
+            }
+            if (opts.willneed) {
+                ::madvise(mapping(), bytes(), MADV_WILLNEED);
+            }
+        }
+
+        // Writes modified pages back to the file before returning
+        void flush() const requires(Mode == access::read_write) {
+            if (size_ != 0 && ::msync(mapping(), bytes(), MS_SYNC) != 0) {
+                throw std::system_error(errno, std::generic_category(), "msync");
+            }
+        }
+
+       private:
+        void map(int fd, std::size_t bytes, std::filesystem::path const &path) {
+            if (bytes == 0) {
+                return;  // empty mappings are not allowed
+            }
+            auto const protection = Mode == access::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            void *address = ::mmap(nullptr, bytes, protection, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED) {
+                detail::io::throw_errno("Can not map", path);
+            }
+            data_ = static_cast<element_type *>(address);
+            size_ = bytes / sizeof(T);
+        }
+
+        void unmap() noexcept {
+            if (data_ != nullptr) {
+                ::munmap(mapping(), bytes());
+            }
+        }
+
+        [[nodiscard]] void *mapping() const noexcept {
+            return const_cast<std::remove_const_t<element_type> *>(data_);
+        }
+
+        [[nodiscard]] std::size_t bytes() const noexcept {
+            return size_ * sizeof(T);
+        }
+
+        element_type *data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    static_assert(std::ranges::contiguous_range<mapped_column<float>>);
+    static_assert(std::ranges::sized_range<mapped_column<float>>);
+
+}  // namespace zip_utils::io
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+
+#include "detail/thread_pool.hpp"
+#include "zip_utils.hpp"
+
+
+namespace zip_utils::parallel {
+
+    struct options {
+        std::size_t threads = 0;            // 0: every thread of the pool, the caller included
+        std::size_t chunk_size = 0;         // 0: chosen from `grain_size` and `chunks_per_thread`
+        std::size_t grain_size = 1024;      // the smallest automatic chunk
+        std::size_t chunks_per_thread = 4;  // more chunks than threads leave room for stealing
+    };
+
+}  // namespace zip_utils::parallel
+
+
+namespace zip_utils::detail::parallel {
+
+    // Calls body(first, last, offset) for consecutive chunks of the range, offset being the index of `first`.
+    // Ranges without random access run in a single chunk on the calling thread.
+    template <std::ranges::range Range, typename Body>
+    void run_chunked(Range &range, zip_utils::parallel::options const &options, Body &&body) {
+        if constexpr (std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>) {
+            auto &pool = pool::thread_pool::instance();
+            auto const first = std::ranges::begin(range);
+            auto const size = static_cast<std::size_t>(std::ranges::size(range));
+            auto const threads = options.threads == 0 ? pool.concurrency() : options.threads;
+
+            std::size_t chunk_size = options.chunk_size;
+            if (chunk_size == 0) {
+                auto const chunks = std::max<std::size_t>(threads * options.chunks_per_thread, 1);
+                chunk_size = std::max(options.grain_size, (size + chunks - 1) / chunks);
+            }
+            chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+            auto task = [&](std::size_t chunk) {
+                auto const offset = chunk * chunk_size;
+                auto const last = std::min(size, offset + chunk_size);
+                using difference = std::ranges::range_difference_t<Range>;
+                body(first + static_cast<difference>(offset), first + static_cast<difference>(last), offset);
+            };
+            pool.run((size + chunk_size - 1) / chunk_size, threads, task);
+        } else {
+            body(std::ranges::begin(range), std::ranges::end(range), std::size_t{0});
+        }
+    }
+
+}  // namespace zip_utils::detail::parallel
+
+
+namespace zip_utils::parallel {
+
+    template <std::ranges::range Range, typename Function>
+    void for_each(Range &&range, Function function, options const &options = {}) {
+        detail::parallel::run_chunked(range, options, [&](auto first, auto last, std::size_t) {
+            for (; first != last; ++first) {
+                auto &&row = *first;
+                function(row);
+            }
+        });
+    }
+
+    // Like `for_each`, but also passes the global index of every row: function(index, row)
+    template <std::ranges::range Range, typename Function>
+    void enumerate(Range &&range, Function function, options const &options = {}) {
+        detail::parallel::run_chunked(range, options, [&](auto first, auto last, std::size_t index) {
+            for (; first != last; ++first, ++index) {
+                auto &&row = *first;
+                function(index, row);
+            }
+        });
+    }
+
+}  // namespace zip_utils::parallel
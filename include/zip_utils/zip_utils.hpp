@@ -1,29 +1,178 @@
 #pragma once
 
+#include <source_location>
+
+#include "detail/adjacent.hpp"
+#include "detail/chunked.hpp"
 #include "detail/configuration.hpp"
 #include "detail/counter.hpp"
 #include "detail/impl.hpp"
+#include "detail/merge_join.hpp"
+#include "detail/unzip.hpp"
 #include "detail/utils.hpp"
 
 namespace zip_utils::views {
 
     template <configuration::zip_config Config = configuration::zip_config::NONE,
-              std::ranges::forward_range... Containers>
+              std::ranges::input_range... Containers>
+    requires(!configuration::contains<Config, configuration::zip_config::INSTRUMENT>)
     constexpr auto zip(Containers &&...containers) noexcept(
         detail::utils::all_are_lvalues_or_nothrow_movable<Containers &&...>()) {
-        using namespace detail::impl;
-        using impl = zip_impl<Config, detail::utils::remove_rvalue_ref_t<Containers>...>;
-        return impl(std::forward<Containers>(containers)...);
+        return detail::impl::make_zip<Config>({}, std::forward<Containers>(containers)...);
+    }
+
+    // Range adaptor closure: `range | zip()` is `zip(range)`, instrumented zips are recorded where it is created
+    template <configuration::zip_config Config = configuration::zip_config::NONE>
+    constexpr auto zip(detail::impl::call_site_t<Config> site = std::source_location::current()) noexcept {
+        return detail::utils::range_adaptor{[site]<std::ranges::input_range Range>(Range &&range) noexcept(
+                                                noexcept(detail::impl::make_zip<Config>(site, std::declval<Range>()))) {
+            return detail::impl::make_zip<Config>(site, std::forward<Range>(range));
+        }};
+    }
+
+    // A zip of inputs of the same length: only the first bounded input is checked for the end,
+    // debug builds assert that the others end with it
+    template <configuration::zip_config Config = configuration::zip_config::NONE,
+              std::ranges::input_range... Containers>
+    requires(!configuration::contains<Config, configuration::zip_config::INSTRUMENT>)
+    constexpr auto zip_equal(Containers &&...containers) noexcept(
+        noexcept(zip<Config | configuration::zip_config::EQUAL_LENGTHS>(std::forward<Containers>(containers)...))) {
+        return zip<Config | configuration::zip_config::EQUAL_LENGTHS>(std::forward<Containers>(containers)...);
+    }
+
+    // Unbounded, random access count `start, start + step, ...` of the given index type
+    template <std::integral Index = std::size_t>
+    constexpr auto counter(Index start = 0, Index step = 1) noexcept {
+        return detail::counter::counter<Index>(start, step);
+    }
+
+    // `count` indices `start, start + step, ...` of the given index type
+    template <std::integral Index = std::size_t>
+    constexpr auto bounded_counter(std::size_t count, Index start = 0, Index step = 1) noexcept {
+        return detail::counter::counter<Index, true>(start, step, count);
+    }
+
+    template <std::integral Index, configuration::zip_config Config = configuration::zip_config::NONE,
+              std::ranges::input_range... Containers>
+    requires(!configuration::contains<Config, configuration::zip_config::INSTRUMENT>)
+    constexpr auto enumerate(Containers &&...containers) noexcept(
+        noexcept(zip<Config>(counter<Index>(), std::forward<Containers>(containers)...))) {
+        return zip<Config>(counter<Index>(), std::forward<Containers>(containers)...);
     }
 
     template <configuration::zip_config Config = configuration::zip_config::NONE,
-              std::ranges::forward_range... Containers>
+              std::ranges::input_range... Containers>
+    requires(!configuration::contains<Config, configuration::zip_config::INSTRUMENT>)
     constexpr auto enumerate(Containers &&...containers) noexcept(
-        noexcept(zip(detail::counter::counter{}, std::forward<Containers>(containers)...))) {
-        using namespace detail::counter;
-        return zip<Config>(counter{}, std::forward<Containers>(containers)...);
+        noexcept(enumerate<std::size_t, Config>(std::forward<Containers>(containers)...))) {
+        return enumerate<std::size_t, Config>(std::forward<Containers>(containers)...);
     }
 
+    // Range adaptor closures: `range | enumerate()` is `enumerate(range)`
+    template <std::integral Index, configuration::zip_config Config = configuration::zip_config::NONE>
+    constexpr auto enumerate(detail::impl::call_site_t<Config> site = std::source_location::current()) noexcept {
+        return detail::utils::range_adaptor{[site]<std::ranges::input_range Range>(Range &&range) noexcept(
+                                                noexcept(detail::impl::make_zip<Config>(site, counter<Index>(),
+                                                                                        std::forward<Range>(range)))) {
+            return detail::impl::make_zip<Config>(site, counter<Index>(), std::forward<Range>(range));
+        }};
+    }
+
+    template <configuration::zip_config Config = configuration::zip_config::NONE>
+    constexpr auto enumerate(detail::impl::call_site_t<Config> site = std::source_location::current()) noexcept {
+        return enumerate<std::size_t, Config>(site);
+    }
+
+    // Instrumented zips record their iterations under the location they are created at. It is a default argument
+    // after the inputs, which can not be a deduced pack then: there is an overload for every count of inputs.
+#define ZIP_UTILS_INPUTS_1(X) X(0)
+#define ZIP_UTILS_INPUTS_2(X) ZIP_UTILS_INPUTS_1(X), X(1)
+#define ZIP_UTILS_INPUTS_3(X) ZIP_UTILS_INPUTS_2(X), X(2)
+#define ZIP_UTILS_INPUTS_4(X) ZIP_UTILS_INPUTS_3(X), X(3)
+#define ZIP_UTILS_INPUTS_5(X) ZIP_UTILS_INPUTS_4(X), X(4)
+#define ZIP_UTILS_INPUTS_6(X) ZIP_UTILS_INPUTS_5(X), X(5)
+#define ZIP_UTILS_INPUTS_7(X) ZIP_UTILS_INPUTS_6(X), X(6)
+#define ZIP_UTILS_INPUTS_8(X) ZIP_UTILS_INPUTS_7(X), X(7)
+#define ZIP_UTILS_INPUTS_9(X) ZIP_UTILS_INPUTS_8(X), X(8)
+#define ZIP_UTILS_INPUTS_10(X) ZIP_UTILS_INPUTS_9(X), X(9)
+#define ZIP_UTILS_INPUTS_11(X) ZIP_UTILS_INPUTS_10(X), X(10)
+#define ZIP_UTILS_INPUTS_12(X) ZIP_UTILS_INPUTS_11(X), X(11)
+#define ZIP_UTILS_INPUTS_13(X) ZIP_UTILS_INPUTS_12(X), X(12)
+#define ZIP_UTILS_INPUTS_14(X) ZIP_UTILS_INPUTS_13(X), X(13)
+#define ZIP_UTILS_INPUTS_15(X) ZIP_UTILS_INPUTS_14(X), X(14)
+#define ZIP_UTILS_INPUTS_16(X) ZIP_UTILS_INPUTS_15(X), X(15)
+#define ZIP_UTILS_INPUT_TYPE(I) std::ranges::input_range Input##I
+#define ZIP_UTILS_INPUT_PARAMETER(I) Input##I &&input##I
+#define ZIP_UTILS_INPUT_ARGUMENT(I) std::forward<Input##I>(input##I)
+#define ZIP_UTILS_INSTRUMENTED(N)                                                                                    \
+    template <configuration::zip_config Config, ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_TYPE)>                          \
+    requires configuration::contains<Config, configuration::zip_config::INSTRUMENT>                                  \
+    constexpr auto zip(ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_PARAMETER),                                              \
+                       detail::impl::call_site_t<Config> site = std::source_location::current()) {                   \
+        return detail::impl::make_zip<Config>(site, ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_ARGUMENT));                 \
+    }                                                                                                                \
+                                                                                                                     \
+    template <configuration::zip_config Config, ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_TYPE)>                          \
+    requires configuration::contains<Config, configuration::zip_config::INSTRUMENT>                                  \
+    constexpr auto zip_equal(ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_PARAMETER),                                        \
+                             detail::impl::call_site_t<Config> site = std::source_location::current()) {             \
+        return detail::impl::make_zip<Config | configuration::zip_config::EQUAL_LENGTHS>(                            \
+            site, ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_ARGUMENT));                                                   \
+    }                                                                                                                \
+                                                                                                                     \
+    template <std::integral Index, configuration::zip_config Config, ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_TYPE)>     \
+    requires configuration::contains<Config, configuration::zip_config::INSTRUMENT>                                  \
+    constexpr auto enumerate(ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_PARAMETER),                                        \
+                             detail::impl::call_site_t<Config> site = std::source_location::current()) {             \
+        return detail::impl::make_zip<Config>(site, counter<Index>(), ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_ARGUMENT)); \
+    }                                                                                                                \
+                                                                                                                     \
+    template <configuration::zip_config Config, ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_TYPE)>                          \
+    requires configuration::contains<Config, configuration::zip_config::INSTRUMENT>                                  \
+    constexpr auto enumerate(ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_PARAMETER),                                        \
+                             detail::impl::call_site_t<Config> site = std::source_location::current()) {             \
+        return detail::impl::make_zip<Config>(site, counter<std::size_t>(),                                           \
+                                              ZIP_UTILS_INPUTS_##N(ZIP_UTILS_INPUT_ARGUMENT));                       \
+    }
+
+    ZIP_UTILS_INSTRUMENTED(1)
+    ZIP_UTILS_INSTRUMENTED(2)
+    ZIP_UTILS_INSTRUMENTED(3)
+    ZIP_UTILS_INSTRUMENTED(4)
+    ZIP_UTILS_INSTRUMENTED(5)
+    ZIP_UTILS_INSTRUMENTED(6)
+    ZIP_UTILS_INSTRUMENTED(7)
+    ZIP_UTILS_INSTRUMENTED(8)
+    ZIP_UTILS_INSTRUMENTED(9)
+    ZIP_UTILS_INSTRUMENTED(10)
+    ZIP_UTILS_INSTRUMENTED(11)
+    ZIP_UTILS_INSTRUMENTED(12)
+    ZIP_UTILS_INSTRUMENTED(13)
+    ZIP_UTILS_INSTRUMENTED(14)
+    ZIP_UTILS_INSTRUMENTED(15)
+    ZIP_UTILS_INSTRUMENTED(16)
+
+#undef ZIP_UTILS_INSTRUMENTED
+#undef ZIP_UTILS_INPUT_ARGUMENT
+#undef ZIP_UTILS_INPUT_PARAMETER
+#undef ZIP_UTILS_INPUT_TYPE
+#undef ZIP_UTILS_INPUTS_16
+#undef ZIP_UTILS_INPUTS_15
+#undef ZIP_UTILS_INPUTS_14
+#undef ZIP_UTILS_INPUTS_13
+#undef ZIP_UTILS_INPUTS_12
+#undef ZIP_UTILS_INPUTS_11
+#undef ZIP_UTILS_INPUTS_10
+#undef ZIP_UTILS_INPUTS_9
+#undef ZIP_UTILS_INPUTS_8
+#undef ZIP_UTILS_INPUTS_7
+#undef ZIP_UTILS_INPUTS_6
+#undef ZIP_UTILS_INPUTS_5
+#undef ZIP_UTILS_INPUTS_4
+#undef ZIP_UTILS_INPUTS_3
+#undef ZIP_UTILS_INPUTS_2
+#undef ZIP_UTILS_INPUTS_1
+
     template <typename Value, std::same_as<Value>... Values>
     constexpr auto indexed(Value &&value, Values &&...values) noexcept(
         noexcept(enumerate(std::array<std::decay_t<Value>, 1>{std::forward<Value>(value)}))) {
@@ -31,4 +180,121 @@ namespace zip_utils::views {
                                                                                 std::forward<Values>(values)...});
     }
 
+    // Consecutive blocks of `size` > 0 rows, the last one may be shorter. Blocks of contiguous inputs are spans:
+    // a tuple of them for a zip. Blocks of other ranges are subranges.
+    template <std::ranges::forward_range Range>
+    constexpr auto chunked(Range &&range, std::size_t size) noexcept(
+        std::is_nothrow_constructible_v<detail::utils::remove_rvalue_ref_t<Range>, Range &&>) {
+        using view = detail::chunked::chunked_view<detail::utils::remove_rvalue_ref_t<Range>, std::dynamic_extent>;
+        return view(std::forward<Range>(range), size);
+    }
+
+    template <std::size_t Size, std::ranges::forward_range Range>
+    constexpr auto chunked(Range &&range) noexcept(
+        std::is_nothrow_constructible_v<detail::utils::remove_rvalue_ref_t<Range>, Range &&>) {
+        static_assert(Size > 0, "Chunks can not be empty.");
+        using view = detail::chunked::chunked_view<detail::utils::remove_rvalue_ref_t<Range>, Size>;
+        return view(std::forward<Range>(range), Size);
+    }
+
+    // Windows of N consecutive elements as rows: `for (auto && [a, b, c] : adjacent<3>(v))`. Sized random access
+    // inputs are read at offsets from a single iterator, others keep the last N positions: one step per row.
+    template <std::size_t N, std::ranges::forward_range Range>
+    constexpr auto adjacent(Range &&range) noexcept(
+        std::is_nothrow_constructible_v<detail::utils::remove_rvalue_ref_t<Range>, Range &&>) {
+        static_assert(N > 0, "Windows can not be empty.");
+        using view = detail::adjacent::adjacent_view<detail::utils::remove_rvalue_ref_t<Range>, N>;
+        return view(std::forward<Range>(range));
+    }
+
+    template <std::size_t N>
+    constexpr auto adjacent() noexcept {
+        return detail::utils::range_adaptor{[]<std::ranges::forward_range Range>(Range &&range) noexcept(
+                                                noexcept(adjacent<N>(std::forward<Range>(range)))) {
+            return adjacent<N>(std::forward<Range>(range));
+        }};
+    }
+
+    // `function` of the N elements of every window
+    template <std::size_t N, std::ranges::forward_range Range, typename Function>
+    constexpr auto adjacent_transform(Range &&range, Function function) {
+        using row_function = detail::adjacent::row_function<N, Function>;
+        return adjacent<N>(std::forward<Range>(range)) | std::views::transform(row_function{std::move(function)});
+    }
+
+    template <std::size_t N, typename Function>
+    requires(!std::ranges::range<Function>)
+    constexpr auto adjacent_transform(Function function) {
+        return detail::utils::range_adaptor{
+            [function = std::move(function)]<std::ranges::forward_range Range>(Range &&range) {
+                return adjacent_transform<N>(std::forward<Range>(range), function);
+            }};
+    }
+
+    // Rows of two ranges sorted by their keys, aligned by key: `auto [order, customer] = *it`.
+    // With LEFT_OUTER every left row is kept, the right element is then a pointer to it or a null one.
+    template <configuration::join_kind Kind = configuration::join_kind::INNER, std::ranges::forward_range Left,
+              std::ranges::forward_range Right, typename LeftKey, typename RightKey>
+    requires std::indirect_strict_weak_order<std::ranges::less, std::projected<std::ranges::iterator_t<Left>, LeftKey>,
+                                             std::projected<std::ranges::iterator_t<Right>, RightKey>>
+    constexpr auto merge_join(Left &&left, Right &&right, LeftKey left_key, RightKey right_key) {
+        using view = detail::merge_join::merge_join_view<Kind, detail::utils::remove_rvalue_ref_t<Left>,
+                                                         detail::utils::remove_rvalue_ref_t<Right>, LeftKey, RightKey>;
+        return view(std::forward<Left>(left), std::forward<Right>(right), std::move(left_key), std::move(right_key));
+    }
+
+    template <configuration::join_kind Kind = configuration::join_kind::INNER, std::ranges::forward_range Left,
+              std::ranges::forward_range Right, typename Key = std::identity>
+    constexpr auto merge_join(Left &&left, Right &&right, Key key = {}) -> decltype(merge_join<Kind>(
+        std::forward<Left>(left), std::forward<Right>(right), key, key)) {
+        return merge_join<Kind>(std::forward<Left>(left), std::forward<Right>(right), key, key);
+    }
+
 }  // namespace zip_utils::views
+
+
+namespace zip_utils {
+
+    // Output iterator appending each column of the assigned rows to its container, `zip` in reverse
+    template <typename... Containers>
+    constexpr auto zip_inserter(Containers &...containers) noexcept {
+        return detail::unzip::zip_insert_iterator<false, Containers...>(containers...);
+    }
+
+    // Appends each column of the rows to its container in a single pass. Only ranges that are both sized and
+    // forward reserve: their size is taken once, before the pass. With MOVE_FROM_RVALUES, elements of an rvalue
+    // container are moved. Returns the number of rows.
+    template <configuration::zip_config Config = configuration::zip_config::NONE, std::ranges::input_range Range,
+              typename... Containers>
+    constexpr std::size_t unzip(Range &&range, Containers &...containers) {
+        constexpr bool move = configuration::contains<Config, configuration::zip_config::MOVE_FROM_RVALUES> &&
+                              detail::unzip::owns_elements<Range &&>;
+        detail::unzip::zip_insert_iterator<move, Containers...> out(containers...);
+        if constexpr (std::ranges::sized_range<Range> && std::ranges::forward_range<Range>) {
+            auto const size = static_cast<std::size_t>(std::ranges::size(range));
+            out.reserve(size);
+        }
+
+        std::size_t rows = 0;
+        for (auto &&row : range) {
+            out = std::forward<decltype(row)>(row);
+            ++rows;
+        }
+        return rows;
+    }
+
+    // The columns of the rows as new containers: `to_columns<std::vector<int>, std::deque<char>>(rows)`
+    template <configuration::zip_config Config, std::default_initializable... Containers,
+              std::ranges::input_range Range>
+    constexpr std::tuple<Containers...> to_columns(Range &&range) {
+        std::tuple<Containers...> columns;
+        std::apply([&](auto &...containers) { unzip<Config>(std::forward<Range>(range), containers...); }, columns);
+        return columns;
+    }
+
+    template <std::default_initializable... Containers, std::ranges::input_range Range>
+    constexpr std::tuple<Containers...> to_columns(Range &&range) {
+        return to_columns<configuration::zip_config::NONE, Containers...>(std::forward<Range>(range));
+    }
+
+}  // namespace zip_utils
@@ -0,0 +1,119 @@
+# Compiles kernels.cpp to assembly and checks that the zip kernels cost the same as the index loops.
+#
+# Usage: cmake -DCOMPILER=<c++ compiler> -DOPTIMIZATION=<O2|O3> -DSOURCE=<kernels.cpp> -DINCLUDE=<include dir>
+#              -DOUTPUT=<assembly file> -P check_codegen.cmake
+
+foreach (variable COMPILER OPTIMIZATION SOURCE INCLUDE OUTPUT)
+    if (NOT DEFINED ${variable})
+        message(FATAL_ERROR "${variable} is not set")
+    endif ()
+endforeach ()
+
+# Zip kernels, the index loops they are compared with, and whether the pair must vectorize
+set(KERNELS zip_sum enumerate_scatter zip_fibonacci adjacent_fibonacci zip_equal_sum)
+set(zip_sum_BASELINE index_sum)
+set(zip_sum_VECTORIZED ON)
+set(enumerate_scatter_BASELINE index_scatter)
+set(enumerate_scatter_VECTORIZED ON)
+# Three views over one vector: the zip loop gets a versioned alias check the index loop does not need
+set(zip_fibonacci_BASELINE "")
+set(zip_fibonacci_VECTORIZED OFF)
+# Windows over one vector are offsets from one pointer, so no alias check is needed
+set(adjacent_fibonacci_BASELINE index_fibonacci)
+set(adjacent_fibonacci_VECTORIZED OFF)
+# Lists of the same length: one end check per row, like a loop over the first list only
+set(zip_equal_sum_BASELINE lead_sum)
+set(zip_equal_sum_VECTORIZED OFF)
+
+# Allowed instruction count of a zip kernel: ratio * baseline + slack
+set(RATIO_PERCENT 125)
+set(SLACK 8)
+
+execute_process(COMMAND ${COMPILER} --version OUTPUT_VARIABLE version)
+execute_process(COMMAND ${COMPILER} -dumpmachine OUTPUT_VARIABLE machine)
+
+# GCC vectorizes only at -O3 by default, Clang at -O2 too
+if (version MATCHES "clang")
+    set(expect_vectors ON)
+elseif (OPTIMIZATION STREQUAL "O3")
+    set(expect_vectors ON)
+else ()
+    set(expect_vectors OFF)
+endif ()
+if (NOT machine MATCHES "x86_64|amd64")
+    message(STATUS "Vector instructions are only checked on x86-64, target is ${machine}")
+    set(expect_vectors OFF)
+endif ()
+
+execute_process(
+    COMMAND ${COMPILER} -std=c++20 -${OPTIMIZATION} -DNDEBUG -fno-asynchronous-unwind-tables -I${INCLUDE}
+            -S ${SOURCE} -o ${OUTPUT}
+    RESULT_VARIABLE status
+    ERROR_VARIABLE errors)
+if (NOT status EQUAL 0)
+    message(FATAL_ERROR "Compilation failed:\n${errors}")
+endif ()
+
+file(READ ${OUTPUT} assembly)
+
+# Instructions of `name`, one list element per instruction
+function(read_function name out)
+    string(FIND "${assembly}" "\n${name}:\n" begin)
+    string(FIND "${assembly}" "\t.size\t${name}," end)
+    if (begin EQUAL -1 OR end EQUAL -1)
+        message(FATAL_ERROR "Function ${name} is not found in ${OUTPUT}")
+    endif ()
+    math(EXPR length "${end} - ${begin}")
+    string(SUBSTRING "${assembly}" ${begin} ${length} body)
+    string(REPLACE ";" "," body "${body}")
+    string(REPLACE "\n" ";" lines "${body}")
+
+    set(instructions)
+    foreach (line IN LISTS lines)
+        if (line MATCHES "^\t[a-z]" AND NOT line MATCHES "^\t\\.")
+            list(APPEND instructions "${line}")
+        endif ()
+    endforeach ()
+    set(${out} "${instructions}" PARENT_SCOPE)
+endfunction()
+
+set(failures)
+foreach (kernel IN LISTS KERNELS)
+    read_function(${kernel} instructions)
+    list(LENGTH instructions count)
+
+    foreach (instruction IN LISTS instructions)
+        if (instruction MATCHES "^\t(call|jmp)[a-z]*\t[^.]")
+            list(APPEND failures "${kernel}: out-of-line call:${instruction}")
+        endif ()
+    endforeach ()
+
+    if (expect_vectors AND ${kernel}_VECTORIZED)
+        set(vectorized OFF)
+        foreach (instruction IN LISTS instructions)
+            if (instruction MATCHES "^\tv?p(add|sub|mul|shuf|unpck)[a-z]*\t")
+                set(vectorized ON)
+            endif ()
+        endforeach ()
+        if (NOT vectorized)
+            list(APPEND failures "${kernel}: no packed vector instructions")
+        endif ()
+    endif ()
+
+    if (NOT "${${kernel}_BASELINE}" STREQUAL "")
+        read_function(${${kernel}_BASELINE} baseline)
+        list(LENGTH baseline baseline_count)
+        math(EXPR limit "${baseline_count} * ${RATIO_PERCENT} / 100 + ${SLACK}")
+        message(STATUS "${kernel}: ${count} instructions, ${${kernel}_BASELINE}: ${baseline_count}")
+        if (count GREATER limit)
+            list(APPEND failures "${kernel}: ${count} instructions, more than ${limit} allowed by ${${kernel}_BASELINE}")
+        endif ()
+    else ()
+        message(STATUS "${kernel}: ${count} instructions")
+    endif ()
+endforeach ()
+
+if (failures)
+    string(REPLACE ";" "\n" failures "${failures}")
+    message(FATAL_ERROR "Codegen check failed at -${OPTIMIZATION}:\n${failures}")
+endif ()
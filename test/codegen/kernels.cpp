@@ -0,0 +1,80 @@
+// Canonical zip loops next to the hand-written loops they should compile to.
+// Kernels have C linkage, so check_codegen.cmake can find them in the assembly by name.
+
+#include <cstddef>
+#include <forward_list>
+#include <ranges>
+#include <vector>
+
+#include "zip_utils/zip_utils.hpp"
+
+using namespace zip_utils::views;
+
+
+extern "C" {
+
+int zip_sum(std::vector<int> const &a, std::vector<int> const &b) {
+    int sum = 0;
+    for (auto const &[x, y] : zip(a, b)) {
+        sum += x * y;
+    }
+    return sum;
+}
+
+int index_sum(std::vector<int> const &a, std::vector<int> const &b) {
+    int sum = 0;
+    auto const n = std::min(a.size(), b.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void enumerate_scatter(std::vector<int> &v) {
+    for (auto &&[i, x] : enumerate(v)) {
+        x = static_cast<int>(i) * 3;
+    }
+}
+
+void index_scatter(std::vector<int> &v) {
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        v[i] = static_cast<int>(i) * 3;
+    }
+}
+
+void zip_fibonacci(std::vector<int> &f) {
+    using std::views::drop;
+    for (auto &&[f0, f1, f2] : zip(f, f | drop(1), f | drop(2))) {
+        f2 = f0 + f1;
+    }
+}
+
+void adjacent_fibonacci(std::vector<int> &f) {
+    for (auto &&[f0, f1, f2] : adjacent<3>(f)) {
+        f2 = f0 + f1;
+    }
+}
+
+void index_fibonacci(std::vector<int> &f) {
+    for (std::size_t i = 2; i < f.size(); ++i) {
+        f[i] = f[i - 2] + f[i - 1];
+    }
+}
+
+int zip_equal_sum(std::forward_list<int> const &a, std::forward_list<int> const &b) {
+    int sum = 0;
+    for (auto const &[x, y] : zip_equal(a, b)) {
+        sum += x * y;
+    }
+    return sum;
+}
+
+int lead_sum(std::forward_list<int> const &a, std::forward_list<int> const &b) {
+    int sum = 0;
+    for (auto x = a.begin(), y = b.begin(); x != a.end(); ++x, ++y) {
+        sum += *x * *y;
+    }
+    return sum;
+}
+
+}  // extern "C"
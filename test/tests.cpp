@@ -1,13 +1,31 @@
+#include <zip_utils/algorithms.hpp>
+#include <zip_utils/async.hpp>
+#include <zip_utils/io.hpp>
+#include <zip_utils/parallel.hpp>
 #include <zip_utils/zip_utils.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <array>
+#include <deque>
+#include <filesystem>
+#include <forward_list>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <list>
 #include <map>
+#include <memory>
+#include <numeric>
 #include <ranges>
 #include <set>
+#include <span>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 using namespace zip_utils::views;
@@ -67,27 +85,46 @@ TEST_CASE("References", "[zip]") {
         std::array<A, 1> a = { A(0) };
         std::array<int, 1> b{};
 
-        INFO("`a` is passed by reference, and its elements are copied."
-             "Assignment doesn't affect `a`.");
+        INFO("Rows are returned by value as tuples of references, like std::views::zip: "
+             "`a`'s elements are not copied, assignment changes them.");
         for (auto [x, y] : zip(a, b)) {
             x.value = 3;
         }
 
+        REQUIRE(A::copies() == 0);
+        REQUIRE(A::moves() == 0);
+        REQUIRE(a[0].value == 3);
+    }
+
+
+    SECTION("value_type row = zip(a, b)"){
+        using A = NewTypeCMC;
+
+        std::array<A, 1> a = { A(0) };
+        std::array<int, 1> b{};
+
+        INFO("`a` is passed by reference, and its elements are copied to the value type."
+             "Assignment doesn't affect `a`.");
+        for (std::ranges::range_value_t<decltype(zip(a, b))> row : zip(a, b)) {
+            auto& [x, y] = row;
+            x.value = 3;
+        }
+
         REQUIRE(A::copies() == 1);
         REQUIRE(A::moves() == 0);
         REQUIRE(a[0].value == 0);
     }
 
 
-    SECTION("auto & [x, y] = zip(a, b)"){
+    SECTION("auto const & [x, y] = zip(a, b)"){
         using A = NewTypeCMC;
 
         std::array<A, 1> a = { A(0) };
         std::array<int, 1> b{};
 
-        INFO("`a` and its elements are passed by reference."
+        INFO("`a` and its elements are passed by reference, a const row still refers to mutable elements."
              "Assignment changes `a`'s elements.");
-        for (auto& [x, y] : zip(a, b)) {
+        for (auto const& [x, y] : zip(a, b)) {
             x.value = 3;
         }
 
@@ -95,7 +132,7 @@ TEST_CASE("References", "[zip]") {
         REQUIRE(A::moves() == 0);
         REQUIRE(a[0].value == 3);
 
-        for (auto& [x, y] : zip(a, b)) {
+        for (auto const& [x, y] : zip(a, b)) {
             A _ = x;
             (void) _;
         }
@@ -135,21 +172,24 @@ TEST_CASE("References", "[zip]") {
         std::array<A, 1> a = { A(12) };
         std::array<int, 1> b{};
 
-        INFO("`a` is moved inside zip object, its elements are copied to x.");
+        INFO("`a` is moved inside zip object, x refers to its elements.");
         for (auto [x, y] : zip(std::move(a), b)) {
+            STATIC_REQUIRE(std::is_lvalue_reference_v<decltype(x)>);
             x.value = 4;
         }
 
-        REQUIRE(A::copies() == 1);
+        REQUIRE(A::copies() == 0);
         REQUIRE(A::moves() == 1);
         REQUIRE(a[0].value == 0); // NOLINT(bugprone-use-after-move)
 
         a = { A(12) };
         A::reset();
 
-        INFO("`a` is moved inside zip object, its elements are moved to x.");
+        INFO("`a` is moved inside zip object, x is an rvalue reference to its elements.");
         for (auto [x, y] : zip<zip_config::MOVE_FROM_RVALUES>(std::move(a), b)) {
-            x.value = 4;
+            STATIC_REQUIRE(std::is_rvalue_reference_v<decltype(x)>);
+            A moved = std::move(x);
+            REQUIRE(moved.value == 12);
         }
 
         REQUIRE(A::copies() == 0);
@@ -157,7 +197,7 @@ TEST_CASE("References", "[zip]") {
         REQUIRE(a[0].value == 0); // NOLINT(bugprone-use-after-move)
     }
 
-    SECTION("auto & [x, y] = zip(move(a), b)"){
+    SECTION("auto const & [x, y] = zip(move(a), b)"){
         using A = NewTypeCMC;
 
         std::array<A, 1> a = { A(0) };
@@ -165,7 +205,7 @@ TEST_CASE("References", "[zip]") {
 
         INFO("`a` is moved inside zip object, "
              "its elements are taken by reference.");
-        for (auto & [x, y] : zip(std::move(a), b)) {
+        for (auto const & [x, y] : zip(std::move(a), b)) {
             x.value = 4;
         }
 
@@ -197,23 +237,24 @@ TEST_CASE("References", "[zip]") {
         std::array<int, 1> b{};
 
         INFO("Collection is moved inside zip object, "
-             "its elements are moved to x.");
+             "its elements are moved from x.");
         for (auto [x, y] : zip<zip_config::MOVE_FROM_RVALUES>(std::array<A, 1>{A(12)}, b)) {
-            x.value = 4;
+            A moved = std::move(x);
+            REQUIRE(moved.value == 12);
         }
 
         REQUIRE(A::copies() == 0);
         REQUIRE(A::moves() == 2);
     }
 
-    SECTION("auto & [x, y] = zip(<initializer>, b)"){
+    SECTION("auto const & [x, y] = zip(<initializer>, b)"){
         using A = NewTypeCMC;
 
         std::array<int, 1> b{};
 
         INFO("Collection is moved inside zip object, "
              "its elements are taken by reference.");
-        for (auto & [x, y] : zip(std::array<A, 1>{A(12)}, b)) {
+        for (auto const & [x, y] : zip(std::array<A, 1>{A(12)}, b)) {
             x.value = 4;
         }
 
@@ -242,13 +283,14 @@ TEST_CASE("Modification", "[zip]") {
     std::vector v = {'x', 'y', 'z'};
 
     INFO("Values are copied.");
-    for (auto [x, y] : zip(u, v)) {
+    for (std::ranges::range_value_t<decltype(zip(u, v))> row : zip(u, v)) {
+        auto& [x, y] = row;
         x = y;
     }
     REQUIRE((v[0] != u[0] && v[1] != u[1] && v[2] != u[2]));
 
     INFO("Values are taken by reference.");
-    for (auto& [x, y] : zip(u, v)) {
+    for (auto&& [x, y] : zip(u, v)) {
         x = y;
     }
     REQUIRE((v[0] == u[0] && v[1] == u[1] && v[2] == u[2]));
@@ -261,7 +303,7 @@ TEST_CASE("Containers", "[zip]") {
         std::map<int, std::string> m = {{2, "x"}, {4, "y"}, {8, "no"}};
 
         for (auto [x, y, z] : zip(v, s, m)) {
-            STATIC_REQUIRE(std::is_const_v<decltype(y)>);
+            STATIC_REQUIRE(std::is_const_v<std::remove_reference_t<decltype(y)>>);
             STATIC_REQUIRE(std::is_const_v<decltype(z.first)>);
             REQUIRE((x + 1 == y && z.first == 1 << x));
         }
@@ -271,7 +313,7 @@ TEST_CASE("Containers", "[zip]") {
         int A[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 1000};
         char B[] = {5, 4, 3, 2, 1};
 
-        for (auto& [a, b] : zip(A, B)) {
+        for (auto&& [a, b] : zip(A, B)) {
             REQUIRE(a == 6 - b);
         }
     }
@@ -305,27 +347,28 @@ TEST_CASE("Immutability", "[zip]") {
     std::vector<int> v;
 
     for (auto [x] : zip(v)) {
-        STATIC_REQUIRE(!std::is_const_v<decltype(x)>);
+        STATIC_REQUIRE(!std::is_const_v<std::remove_reference_t<decltype(x)>>);
     }
 
     for (auto [x] : zip(std::as_const(v))) {
-        STATIC_REQUIRE(std::is_const_v<decltype(x)>);
+        STATIC_REQUIRE(std::is_const_v<std::remove_reference_t<decltype(x)>>);
     }
 
-    for (auto& [x] : zip(v)) {
-        STATIC_REQUIRE(!std::is_const_v<decltype(x)>);
+    for (auto&& [x] : zip(v)) {
+        STATIC_REQUIRE(!std::is_const_v<std::remove_reference_t<decltype(x)>>);
     }
 
+    INFO("Rows are tuples of references: a const row still refers to mutable elements, like std::views::zip.");
     for (auto const& [x] : zip(v)) {
-        STATIC_REQUIRE(std::is_const_v<decltype(x)>);
+        STATIC_REQUIRE(!std::is_const_v<std::remove_reference_t<decltype(x)>>);
     }
 
-    for (auto& [x] : zip(std::as_const(v))) {
-        STATIC_REQUIRE(std::is_const_v<decltype(x)>);
+    for (auto&& [x] : zip(std::as_const(v))) {
+        STATIC_REQUIRE(std::is_const_v<std::remove_reference_t<decltype(x)>>);
     }
 
     for (auto const& [x] : zip(std::as_const(v))) {
-        STATIC_REQUIRE(std::is_const_v<decltype(x)>);
+        STATIC_REQUIRE(std::is_const_v<std::remove_reference_t<decltype(x)>>);
     }
 }
 
@@ -397,7 +440,7 @@ TEST_CASE("Example") {
     auto expected = {0, 1, 1, 2, 3, 5, 8, 13, 21, 34};
     using std::views::drop;
 
-    for (auto& [x, y, z] : zip(F, F | drop(1), F | drop(2))) {
+    for (auto&& [x, y, z] : zip(F, F | drop(1), F | drop(2))) {
         z = x + y;
     }
 
@@ -499,11 +542,102 @@ TEST_CASE("Strong exception guarantee", "[zip]") {
     REQUIRE(((x == 7) && (y == 4) && (w == 5)));
 }
 
+namespace {
+
+    // Bidirectional iterator that throws instead of stepping onto its limit
+    struct throwing_iterator {
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+
+        static inline int copies = 0;
+
+        int i = 0;
+        int limit = 0;
+
+        throwing_iterator() = default;
+        throwing_iterator(int i, int limit) : i(i), limit(limit) {}
+        throwing_iterator(throwing_iterator const &other) : i(other.i), limit(other.limit) { ++copies; }
+        throwing_iterator(throwing_iterator &&) noexcept = default;
+        throwing_iterator &operator=(throwing_iterator const &) = default;
+        throwing_iterator &operator=(throwing_iterator &&) noexcept = default;
+
+        int operator*() const { return i; }
+        throwing_iterator &operator++() {
+            if (i + 1 == limit) {
+                throw std::runtime_error("limit");
+            }
+            ++i;
+            return *this;
+        }
+        throwing_iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        throwing_iterator &operator--() noexcept {
+            --i;
+            return *this;
+        }
+        throwing_iterator operator--(int) noexcept {
+            auto copy = *this;
+            --i;
+            return copy;
+        }
+        bool operator==(throwing_iterator const &other) const { return i == other.i; }
+    };
+
+    struct throwing_range {
+        int limit;
+
+        throwing_iterator begin() const { return {0, limit}; }
+        throwing_iterator end() const { return {10, limit}; }
+    };
+
+}  // namespace
+
+TEST_CASE("Exception guarantee modes", "[zip]") {
+    using zip_utils::configuration::zip_config;
+    STATIC_REQUIRE(std::bidirectional_iterator<throwing_iterator>);
+
+    int arr[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    throwing_range never{100}, at_five{5};
+
+    auto run = [](auto z) {
+        auto it = z.begin();
+        throwing_iterator::copies = 0;
+        REQUIRE_THROWS_AS([&] { while (true) ++it; }(), std::runtime_error);
+        return it;
+    };
+
+    SECTION("Strong") {
+        auto it = run(zip(arr, never, at_five));
+        INFO("Only the components that may throw are saved");
+        REQUIRE(throwing_iterator::copies == 2 * 5);
+        auto [x, y, z] = *it;
+        REQUIRE(((x == 4) && (y == 4) && (z == 4)));
+    }
+
+    SECTION("Undo") {
+        auto it = run(zip<zip_config::UNDO_ON_EXCEPTION>(arr, never, at_five));
+        REQUIRE(throwing_iterator::copies == 0);
+        auto [x, y, z] = *it;
+        REQUIRE(((x == 4) && (y == 4) && (z == 4)));
+    }
+
+    SECTION("Basic") {
+        auto it = run(zip<zip_config::BASIC_EXCEPTION_GUARANTEE>(arr, never, at_five));
+        REQUIRE(throwing_iterator::copies == 0);
+        INFO("Components before the throwing one have moved");
+        auto [x, y, z] = *it;
+        REQUIRE(((x == 5) && (y == 5) && (z == 4)));
+    }
+}
+
 TEST_CASE("Skip") {
     std::array<int, 10> F = {0, 1};
     using std::views::drop;
 
-    for (auto& [F0, F1, F2] : zip(F, F | drop(1), F | drop(2))) {
+    for (auto&& [F0, F1, F2] : zip(F, F | drop(1), F | drop(2))) {
         F2 = F0 + F1;
     }
 
@@ -524,4 +658,1487 @@ TEST_CASE("Enumerate elems") {
     for (auto [i, val] : indexed(0u, 1u, 2u, 3u, 4u, 5u)) {
         REQUIRE(i == val);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Iterator category", "[zip]") {
+    std::vector<int> v = {5, 4, 3, 2, 1};
+    std::array<char, 4> a = {'a', 'b', 'c', 'd'};
+    std::list<int> l = {1, 2, 3};
+    std::forward_list<int> f = {1, 2, 3};
+
+    STATIC_REQUIRE(std::ranges::random_access_range<decltype(zip(v, a))>);
+    STATIC_REQUIRE(std::is_same_v<std::ranges::range_difference_t<decltype(zip(v, a))>, std::ptrdiff_t>);
+    STATIC_REQUIRE(std::ranges::bidirectional_range<decltype(zip(v, l))>);
+    STATIC_REQUIRE(!std::ranges::random_access_range<decltype(zip(v, l))>);
+    STATIC_REQUIRE(std::ranges::forward_range<decltype(zip(l, f))>);
+    STATIC_REQUIRE(!std::ranges::bidirectional_range<decltype(zip(l, f))>);
+
+    SECTION("Random access") {
+        auto z = zip(v, a);
+        auto it = z.begin();
+
+        REQUIRE(z.end() - z.begin() == 4);
+        REQUIRE(std::ranges::distance(z) == 4);
+
+        it += 3;
+        auto [x, y] = *it;
+        REQUIRE((x == 2 && y == 'd'));
+        REQUIRE(it - z.begin() == 3);
+        REQUIRE(z.begin() < it);
+        REQUIRE(it + 1 == z.end());
+
+        auto first = z.begin();
+        auto&& [p, q] = first[2];
+        REQUIRE((p == 3 && q == 'c'));
+
+        auto found = std::ranges::lower_bound(z.begin(), z.end(), 'c', {}, [](auto const& row) {
+            auto const& [_, chr] = row;
+            return chr;
+        });
+        REQUIRE(found - z.begin() == 2);
+    }
+
+    SECTION("Bidirectional") {
+        auto z = zip(v, l);
+        auto it = std::ranges::next(z.begin(), 2);
+        --it;
+        auto [x, y] = *it;
+        REQUIRE((x == 4 && y == 2));
+    }
+
+    SECTION("End of random access zip is aligned") {
+        auto z = zip(v, a);
+        auto [x, y] = *std::ranges::prev(z.end());
+        REQUIRE((x == 2 && y == 'd'));
+    }
+
+    SECTION("Reverse") {
+        INFO("Rows do not refer into the iterator, so reverse iterators may dereference their temporaries.");
+        STATIC_REQUIRE(!std::is_reference_v<std::ranges::range_reference_t<decltype(zip(v, a))>>);
+
+        std::string chars;
+        for (auto [x, y] : zip(v, a) | std::views::reverse) {
+            REQUIRE(x == 'f' - y);
+            chars += y;
+        }
+        REQUIRE(chars == "dcba");
+
+        auto rit = std::make_reverse_iterator(zip(v, a).end());
+        auto [x, y] = rit[1];
+        REQUIRE((x == 3 && y == 'c'));
+        x = 30;
+        REQUIRE(v[2] == 30);
+    }
+}
+
+
+TEST_CASE("Sized", "[zip]") {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    std::list<int> l = {1, 2, 3, 4};
+    std::set<int> s = {1, 2, 3};
+
+    STATIC_REQUIRE(std::ranges::sized_range<decltype(zip(v, l, s))>);
+    REQUIRE(std::ranges::size(zip(v, l)) == 4);
+    REQUIRE(std::ranges::size(zip(v, l, s)) == 3);
+    REQUIRE(std::ranges::size(zip(std::vector<int>{})) == 0);
+
+    std::size_t rows = 0;
+    for (auto [x, y, z] : zip(l, s, v)) {
+        REQUIRE((x == y && y == z));
+        ++rows;
+    }
+    REQUIRE(rows == 3);
+
+    auto z = zip(v, l);
+    REQUIRE(std::ranges::distance(z.begin(), z.end()) == 4);
+}
+
+
+TEST_CASE("Sentinels", "[zip]") {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    std::list<int> l = {5, 6, 7};
+
+    SECTION("Unbounded") {
+        auto z = zip(v, std::views::iota(1));
+        STATIC_REQUIRE(std::ranges::common_range<decltype(z)>);
+        STATIC_REQUIRE(std::ranges::random_access_range<decltype(z)>);
+        REQUIRE(std::ranges::size(z) == 5);
+
+        for (auto [x, i] : z) {
+            REQUIRE(x == i);
+        }
+
+        std::size_t rows = 0;
+        for (auto [x, i, y] : zip(l, std::views::iota(0), std::ranges::subrange(v.begin(), std::unreachable_sentinel))) {
+            REQUIRE((x == i + 5 && y == i + 1));
+            ++rows;
+        }
+        REQUIRE(rows == 3);
+    }
+
+    SECTION("Non-common") {
+        auto small = [](int x) { return x < 4; };
+        auto z = zip(l, v | std::views::take_while(small));
+        STATIC_REQUIRE(!std::ranges::common_range<decltype(z)>);
+
+        std::size_t rows = 0;
+        for (auto [x, y] : zip(v | std::views::take_while(small), l)) {
+            REQUIRE(x + 4 == y);
+            ++rows;
+        }
+        REQUIRE(rows == 3);
+    }
+
+    SECTION("Bidirectional") {
+        auto z = zip(l, v);
+        STATIC_REQUIRE(!std::ranges::common_range<decltype(z)>);
+        REQUIRE(z.end() - z.begin() == 3);
+
+        auto last = std::ranges::prev(std::ranges::next(z.begin(), z.end()));
+        auto [x, y] = *last;
+        REQUIRE((x == 7 && y == 3));
+    }
+}
+
+
+TEST_CASE("Sort", "[zip]") {
+    auto key = [](auto const& row) {
+        auto const& [k, _1, _2] = row;
+        return k;
+    };
+
+    SECTION("ranges::sort") {
+        std::vector<int> keys = {3, 1, 4, 1, 5, 9, 2, 6};
+        std::vector<char> a = {'c', 'a', 'd', 'a', 'e', 'i', 'b', 'f'};
+        std::array<std::string, 8> b = {"3", "1", "4", "1", "5", "9", "2", "6"};
+
+        STATIC_REQUIRE(std::sortable<decltype(zip(keys, a, b).begin()), std::ranges::less, decltype(key)>);
+        std::ranges::sort(zip(keys, a, b), {}, key);
+
+        REQUIRE(std::ranges::is_sorted(keys));
+        for (auto const& [k, x, y] : zip(keys, a, b)) {
+            REQUIRE((x == 'a' + k - 1 && y == std::to_string(k)));
+        }
+    }
+
+    SECTION("std::sort") {
+        INFO("More rows than the insertion sort threshold, so introsort partitions the zip.");
+        std::vector<int> keys(40);
+        int values[40];
+        std::vector<std::string> names(40);
+        for (int i = 0; i < 40; ++i) {
+            keys[i] = i * 17 % 31;
+            values[i] = keys[i] * 10;
+            names[i] = std::to_string(keys[i]);
+        }
+
+        auto z = zip(keys, values, names);
+        std::sort(z.begin(), z.end(), [&](auto const& lhs, auto const& rhs) { return key(lhs) < key(rhs); });
+
+        REQUIRE(std::ranges::is_sorted(keys));
+        for (auto const& [k, v, name] : z) {
+            REQUIRE((v == k * 10 && name == std::to_string(k)));
+        }
+    }
+
+    SECTION("No copies") {
+        using A = NewTypeCMC;
+
+        std::vector<int> keys = {2, 1, 3, 0};
+        std::vector<A> a = {A(2), A(1), A(3), A(0)};
+        A::reset();
+
+        std::ranges::sort(zip(keys, a), {}, [](auto const& row) {
+            auto const& [k, _] = row;
+            return k;
+        });
+
+#if !defined(_GLIBCXX_RELEASE) || _GLIBCXX_RELEASE >= 15
+        // Older libstdc++ sorts through std::move(*it), which copies out of a row of references
+        REQUIRE(A::copies() == 0);
+#endif
+        for (auto const& [k, x] : zip(keys, a)) {
+            REQUIRE(k == x.value);
+        }
+    }
+
+    SECTION("Swap and move") {
+        std::vector<int> u = {1, 2};
+        std::vector<int> v = {3, 4};
+        auto z = zip(u, v);
+
+        std::ranges::iter_swap(z.begin(), std::ranges::next(z.begin()));
+        REQUIRE((u == std::vector{2, 1} && v == std::vector{4, 3}));
+
+        std::iter_value_t<decltype(z.begin())> row = std::ranges::iter_move(z.begin());
+        REQUIRE(row == std::tuple{2, 4});
+
+        *z.begin() = *std::ranges::next(z.begin());
+        REQUIRE((u == std::vector{1, 1} && v == std::vector{3, 3}));
+    }
+}
+
+
+TEST_CASE("Parallel", "[parallel]") {
+    namespace parallel = zip_utils::parallel;
+
+    std::vector<long> v(100'000);
+    std::vector<long> w(v.size() + 10);
+    std::iota(v.begin(), v.end(), 0);
+
+    SECTION("for_each") {
+        parallel::for_each(zip(v, w), [](auto& row) {
+            auto& [x, y] = row;
+            y = 2 * x;
+        }, {.chunk_size = 1000});
+
+        for (auto [x, y] : zip(v, w)) {
+            REQUIRE(y == 2 * x);
+        }
+        REQUIRE(w.back() == 0);
+    }
+
+    SECTION("enumerate") {
+        std::vector<std::size_t> indices(v.size());
+        parallel::enumerate(zip(v, indices), [](std::size_t i, auto& row) {
+            auto& [x, index] = row;
+            index = i + static_cast<std::size_t>(x);
+        }, {.threads = 3, .grain_size = 100});
+
+        for (auto [i, index] : enumerate(indices)) {
+            REQUIRE(index == 2 * i);
+        }
+    }
+
+    SECTION("Forward-only inputs run serially") {
+        std::list<long> l(v.begin(), v.begin() + 100);
+        long sum = 0;
+        parallel::for_each(zip(l, v), [&](auto const& row) {
+            auto const& [x, y] = row;
+            sum += x + y;
+        });
+        REQUIRE(sum == 99 * 100);
+    }
+
+    SECTION("Exceptions") {
+        auto run = [&] {
+            parallel::for_each(zip(v), [](auto const& row) {
+                auto const& [x] = row;
+                if (x == 54321) {
+                    throw std::runtime_error("boom");
+                }
+            }, {.chunk_size = 100});
+        };
+        REQUIRE_THROWS_AS(run(), std::runtime_error);
+    }
+}
+
+
+TEST_CASE("Algorithms", "[algorithms]") {
+    namespace algorithms = zip_utils::algorithms;
+
+    std::vector<float> a(1003);
+    std::vector<float> b(1003);
+    std::vector<double> w(1003);
+    for (auto&& [i, x, y, z] : enumerate(a, b, w)) {
+        x = static_cast<float>(i % 7);
+        y = static_cast<float>(i % 5) - 2.0f;
+        z = 0.5;
+    }
+
+    double expected_dot = 0;
+    for (auto [x, y] : zip(a, b)) {
+        expected_dot += x * y;
+    }
+
+    SECTION("inner_product") {
+        REQUIRE(algorithms::inner_product(zip(a, b), 0.0f) == Approx(expected_dot));
+        REQUIRE(algorithms::inner_product(zip(a, b, w), 0.0) == Approx(expected_dot / 2));
+
+        std::list<float> l(a.begin(), a.end());
+        REQUIRE(algorithms::inner_product(zip(l, b), 0.0f) == Approx(expected_dot));
+    }
+
+    SECTION("reduce") {
+        REQUIRE(algorithms::reduce(w, 0.0) == Approx(501.5));
+        REQUIRE(algorithms::reduce(zip(a), 0.0f) == Approx(3004.0));
+        REQUIRE(algorithms::reduce(std::vector<int>{1, 2, 3}, 1, std::multiplies<>{}) == 6);
+    }
+
+    SECTION("transform") {
+        std::vector<float> out(a.size() + 1, -1.0f);
+        auto last = algorithms::transform(zip(a, b), out.begin(), [](float x, float y) { return 2 * x + y; });
+        REQUIRE(last == out.end() - 1);
+        REQUIRE(out.back() == -1.0f);
+        for (auto [x, y, z] : zip(a, b, out)) {
+            REQUIRE(z == 2 * x + y);
+        }
+
+        std::list<double> generic;
+        algorithms::transform(zip(a, w), std::back_inserter(generic), [](float x, double y) { return x * y; });
+        REQUIRE(generic.size() == a.size());
+    }
+
+    SECTION("transform_reduce") {
+        auto squares = algorithms::transform_reduce(zip(a, b), 0.0, std::plus<>{}, [](float x, float y) {
+            return (x - y) * (x - y);
+        });
+        double expected = 0;
+        for (auto [x, y] : zip(a, b)) {
+            expected += (x - y) * (x - y);
+        }
+        REQUIRE(squares == Approx(expected));
+    }
+}
+
+
+TEST_CASE("Chunked", "[chunked]") {
+    std::vector<int> v = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::array<char, 10> c = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'};
+
+    SECTION("Spans") {
+        auto chunks = chunked<4>(zip(v, c));
+        REQUIRE(std::ranges::size(chunks) == 3);
+
+        std::vector<std::size_t> sizes;
+        for (auto [numbers, letters] : chunks) {
+            STATIC_REQUIRE(std::is_same_v<decltype(numbers), std::span<int>>);
+            REQUIRE(numbers.size() == letters.size());
+            REQUIRE(letters[0] == 'a' + numbers[0]);
+            sizes.push_back(numbers.size());
+            numbers[0] = -1;
+        }
+        REQUIRE(sizes == std::vector<std::size_t>{4, 4, 2});
+        REQUIRE((v[0] == -1 && v[4] == -1 && v[8] == -1));
+    }
+
+    SECTION("Single range") {
+        std::size_t total = 0;
+        for (std::span<int const> chunk : chunked(std::as_const(v), 3)) {
+            total += chunk.size();
+        }
+        REQUIRE(total == 10);
+    }
+
+    SECTION("Sub-zips") {
+        std::list<int> l(v.begin(), v.end());
+        std::vector<std::size_t> sizes;
+        int expected = 0;
+        for (auto block : chunked(zip(l, c), 3)) {
+            sizes.push_back(static_cast<std::size_t>(std::ranges::distance(block)));
+            for (auto [x, y] : block) {
+                REQUIRE(x == expected++);
+                REQUIRE(y == 'a' + x);
+            }
+        }
+        REQUIRE(sizes == std::vector<std::size_t>{3, 3, 3, 1});
+    }
+
+    SECTION("Empty") {
+        std::vector<int> empty;
+        REQUIRE(std::ranges::distance(chunked<8>(zip(empty, c))) == 0);
+    }
+}
+
+
+namespace {
+
+    // Forward iterator over a vector that counts its own copies
+    struct copy_counting_iterator {
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+
+        static inline int copies = 0;
+
+        std::vector<int>::const_iterator it;
+
+        copy_counting_iterator() = default;
+        explicit copy_counting_iterator(std::vector<int>::const_iterator it) : it(it) {}
+        copy_counting_iterator(copy_counting_iterator const &other) : it(other.it) { ++copies; }
+        copy_counting_iterator(copy_counting_iterator &&) noexcept = default;
+        copy_counting_iterator &operator=(copy_counting_iterator const &other) {
+            it = other.it;
+            ++copies;
+            return *this;
+        }
+        copy_counting_iterator &operator=(copy_counting_iterator &&) noexcept = default;
+
+        int const &operator*() const { return *it; }
+        copy_counting_iterator &operator++() noexcept {
+            ++it;
+            return *this;
+        }
+        copy_counting_iterator operator++(int) {
+            auto copy = *this;
+            ++it;
+            return copy;
+        }
+        bool operator==(copy_counting_iterator const &other) const { return it == other.it; }
+    };
+
+    struct copy_counting_range {
+        std::vector<int> data;
+
+        copy_counting_iterator begin() const { return copy_counting_iterator(data.begin()); }
+        copy_counting_iterator end() const { return copy_counting_iterator(data.end()); }
+    };
+
+}  // namespace
+
+
+TEST_CASE("Const iteration", "[zip]") {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+
+    SECTION("Const iterators") {
+        auto const z = zip(v, std::list<char>(5, 'a'));
+        using iterator = decltype(z.begin());
+        STATIC_REQUIRE(std::is_same_v<decltype((*z.begin()).get<0>()), int const &>);
+        STATIC_REQUIRE(std::forward_iterator<iterator>);
+        STATIC_REQUIRE(std::ranges::sized_range<decltype(z)>);
+        REQUIRE(z.size() == 5);
+
+        int sum = 0;
+        for (auto const &[x, c] : z) {
+            sum += x;
+        }
+        REQUIRE(sum == 15);
+    }
+
+    SECTION("No copies per access") {
+        copy_counting_range r{v};
+        auto const z = zip(r, r);
+
+        auto it = z.begin();
+        auto end = z.end();
+        copy_counting_iterator::copies = 0;
+
+        int sum = 0;
+        for (; it != end; ++it) {
+            auto const &[x, y] = *it;
+            sum += x + y + (*it).get<0>();
+        }
+        REQUIRE(sum == 45);
+        REQUIRE(copy_counting_iterator::copies == 0);
+    }
+}
+
+
+TEST_CASE("Counter", "[enumerate]") {
+    std::vector<int> v = {10, 20, 30, 40, 50};
+
+    SECTION("Random access enumerate") {
+        auto e = enumerate(v);
+        STATIC_REQUIRE(std::ranges::random_access_range<decltype(e)>);
+        STATIC_REQUIRE(std::ranges::sized_range<decltype(e)>);
+        REQUIRE(e.size() == 5);
+        REQUIRE(e.end() - e.begin() == 5);
+
+        auto [i, x] = e.begin()[3];
+        REQUIRE((i == 3 && x == 40));
+
+        auto [j, y] = *--e.end();
+        REQUIRE((j == 4 && y == 50));
+    }
+
+    SECTION("Index type") {
+        for (auto [i, x] : enumerate<std::uint32_t>(v)) {
+            STATIC_REQUIRE(std::is_same_v<decltype(i), std::uint32_t>);
+            REQUIRE(x == 10 * static_cast<int>(i + 1));
+        }
+    }
+
+    SECTION("Start and step") {
+        std::vector<int> indices;
+        for (auto [i, x] : zip(counter(100, -10), v)) {
+            indices.push_back(i);
+        }
+        REQUIRE(indices == std::vector<int>{100, 90, 80, 70, 60});
+
+        auto bounded = zip(bounded_counter<short>(3, 1, 2), v);
+        REQUIRE(bounded.size() == 3);
+        std::vector<short> odd;
+        for (auto [i, x] : bounded) {
+            odd.push_back(i);
+        }
+        REQUIRE(odd == std::vector<short>{1, 3, 5});
+    }
+
+    SECTION("64-bit distances") {
+        constexpr std::size_t rows = std::size_t{1} << 33;
+        auto z = zip(bounded_counter<std::uint64_t>(rows), counter());
+        REQUIRE(z.size() == rows);
+        REQUIRE(z.end() - z.begin() == static_cast<std::ptrdiff_t>(rows));
+
+        auto [i, j] = *(z.begin() + static_cast<std::ptrdiff_t>(rows - 1));
+        REQUIRE((i == rows - 1 && j == rows - 1));
+    }
+
+    SECTION("Parallel enumerate") {
+        std::vector<std::size_t> out(10000);
+        zip_utils::parallel::for_each(enumerate(out), [](auto& row) {
+            auto& [i, x] = row;
+            x = i * 2;
+        }, {.threads = 4, .grain_size = 100});
+        for (auto [i, x] : enumerate(out)) {
+            REQUIRE(x == i * 2);
+        }
+    }
+}
+
+
+namespace {
+
+    constexpr int static_dot() {
+        std::array<int, 4> a = {1, 2, 3, 4};
+        int b[4] = {4, 3, 2, 1};
+        int sum = 0;
+        zip(a, b).for_each([&](auto& row) {
+            auto& [x, y] = row;
+            sum += x * y;
+        });
+        return sum;
+    }
+
+}  // namespace
+
+
+TEST_CASE("Static extent", "[zip]") {
+    std::array<int, 4> a = {1, 2, 3, 4};
+    int b[5] = {10, 20, 30, 40, 50};
+    auto z = zip(a, b);
+
+    STATIC_REQUIRE(decltype(z)::extent == 4);
+    STATIC_REQUIRE(z.size() == 4);
+    STATIC_REQUIRE(std::tuple_size_v<decltype(z)> == 4);
+    STATIC_REQUIRE(static_dot() == 20);
+
+    STATIC_REQUIRE(decltype(zip(a, std::span<int, 3>(b, 3)))::extent == 3);
+    STATIC_REQUIRE(decltype(indexed(1, 2, 3))::extent == 3);
+    STATIC_REQUIRE(decltype(zip(a, std::span<int>(b)))::extent == std::dynamic_extent);
+    STATIC_REQUIRE(decltype(zip(a, std::vector<int>{}))::extent == std::dynamic_extent);
+
+    SECTION("Rows") {
+        auto& [r0, r1, r2, r3] = z;
+        auto& [x, y] = r2;
+        REQUIRE((x == 3 && y == 30));
+        x = 7;
+        REQUIRE(a[2] == 7);
+        REQUIRE(std::get<1>(r3) == 40);
+    }
+
+    SECTION("for_each") {
+        z.for_each([](auto& row) {
+            auto& [x, y] = row;
+            y += x;
+        });
+        REQUIRE(std::vector<int>(b, b + 5) == std::vector<int>{11, 22, 33, 44, 50});
+
+        int count = 0;
+        zip(std::vector<int>(100), a).for_each([&](auto&) { ++count; });
+        REQUIRE(count == 4);
+    }
+}
+
+
+TEST_CASE("Mapped columns", "[io]") {
+    using zip_utils::io::access;
+    using zip_utils::io::mapped_column;
+    namespace fs = std::filesystem;
+
+    auto const directory = fs::temp_directory_path() / ("zip_utils_io_test_" + std::to_string(::getpid()));
+    fs::create_directories(directory);
+    auto const floats = directory / "a.bin";
+    auto const ints = directory / "b.bin";
+
+    {
+        std::vector<float> a(1000);
+        std::vector<int> b(1000);
+        for (auto&& [i, x, y] : enumerate(a, b)) {
+            x = static_cast<float>(i) / 2;
+            y = static_cast<int>(i);
+        }
+        std::ofstream(floats, std::ios::binary).write(reinterpret_cast<char const*>(a.data()), 1000 * sizeof(float));
+        std::ofstream(ints, std::ios::binary).write(reinterpret_cast<char const*>(b.data()), 1000 * sizeof(int));
+    }
+
+    SECTION("Read-only") {
+        auto z = zip(mapped_column<float>(floats), mapped_column<int>(ints, {.willneed = true}));
+        STATIC_REQUIRE(std::ranges::random_access_range<decltype(z)>);
+        STATIC_REQUIRE(std::is_same_v<std::tuple_element_t<0, decltype(z.spans())>, std::span<float const>>);
+        REQUIRE(z.size() == 1000);
+
+        for (auto [x, y] : z) {
+            REQUIRE(x * 2 == static_cast<float>(y));
+        }
+        REQUIRE(zip_utils::algorithms::reduce(mapped_column<int>(ints), 0) == 999 * 1000 / 2);
+    }
+
+    SECTION("Read-write") {
+        auto const out = directory / "c.bin";
+        {
+            auto c = mapped_column<double, access::read_write>::create(out, 1000);
+            REQUIRE(c.size() == 1000);
+            for (auto&& [x, y, z] : zip(mapped_column<float>(floats), mapped_column<int>(ints), c)) {
+                z = x + y;
+            }
+            c.flush();
+        }
+        mapped_column<double> c(out);
+        REQUIRE(c.size() == 1000);
+        REQUIRE(c[10] == 15.0);
+
+        auto const perms = fs::status(out).permissions();
+        REQUIRE((perms & (fs::perms::owner_read | fs::perms::owner_write)) ==
+                (fs::perms::owner_read | fs::perms::owner_write));
+        REQUIRE((perms & fs::perms::others_write) == fs::perms::none);
+    }
+
+    SECTION("Errors") {
+        REQUIRE_THROWS_AS(mapped_column<int>(directory / "missing.bin"), std::system_error);
+
+        std::ofstream(directory / "odd.bin", std::ios::binary).write("abc", 3);
+        REQUIRE_THROWS_AS(mapped_column<int>(directory / "odd.bin"), std::invalid_argument);
+
+        std::ofstream(directory / "empty.bin", std::ios::binary);
+        REQUIRE(mapped_column<int>(directory / "empty.bin").empty());
+    }
+
+    fs::remove_all(directory);
+}
+
+
+namespace {
+
+    // Single pass range with a move-only iterator, like a generator
+    class countdown {
+       public:
+        explicit countdown(int from) : from_(from) {}
+
+        class iterator {
+           public:
+            using value_type = int;
+            using difference_type = std::ptrdiff_t;
+
+            explicit iterator(int* current) : current_(current) {}
+            iterator(iterator&&) noexcept = default;
+            iterator& operator=(iterator&&) noexcept = default;
+
+            int const& operator*() const { return *current_; }
+            iterator& operator++() {
+                --*current_;
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+            bool operator==(std::default_sentinel_t) const { return *current_ == 0; }
+
+           private:
+            int* current_;
+        };
+
+        iterator begin() { return iterator(&from_); }
+        std::default_sentinel_t end() const { return {}; }
+
+       private:
+        int from_;
+    };
+
+}  // namespace
+
+
+TEST_CASE("Input ranges", "[zip]") {
+    STATIC_REQUIRE(std::ranges::input_range<countdown>);
+    STATIC_REQUIRE(!std::ranges::forward_range<countdown>);
+    STATIC_REQUIRE(!std::copy_constructible<std::ranges::iterator_t<countdown>>);
+
+    SECTION("istream_view") {
+        std::istringstream stream("10 20 30 40");
+        std::vector<char> names = {'a', 'b', 'c'};
+
+        auto z = zip(std::ranges::istream_view<int>(stream), names);
+        STATIC_REQUIRE(std::ranges::input_range<decltype(z)>);
+        STATIC_REQUIRE(!std::ranges::forward_range<decltype(z)>);
+
+        std::string joined;
+        for (auto [number, name] : z) {
+            joined += name + std::to_string(number);
+        }
+        REQUIRE(joined == "a10b20c30");
+    }
+
+    SECTION("Enumerated stream") {
+        std::istringstream stream("x y z");
+        std::vector<std::size_t> indices;
+        std::string letters;
+        for (auto [i, word] : enumerate(std::ranges::istream_view<std::string>(stream))) {
+            indices.push_back(i);
+            letters += word;
+        }
+        REQUIRE(indices == std::vector<std::size_t>{0, 1, 2});
+        REQUIRE(letters == "xyz");
+    }
+
+    SECTION("Move-only iterators") {
+        countdown c(4);
+        std::vector<int> v = {1, 2, 3, 4, 5, 6};
+        auto z = zip(c, v);
+        auto it = z.begin();
+        STATIC_REQUIRE(!std::copy_constructible<decltype(it)>);
+        STATIC_REQUIRE(std::input_iterator<decltype(it)>);
+
+        int sum = 0;
+        for (; it != z.end(); it++) {
+            auto const& [x, y] = *it;
+            sum += x * y;
+        }
+        REQUIRE(sum == 4 * 1 + 3 * 2 + 2 * 3 + 1 * 4);
+    }
+}
+
+TEST_CASE("Prefetch", "[zip]") {
+    using zip_utils::configuration::prefetch;
+    using zip_utils::configuration::zip_config;
+    using zip_utils::configuration::prefetch_distance;
+
+    STATIC_REQUIRE(prefetch_distance<zip_config::PREFETCH> == zip_utils::configuration::default_prefetch_distance);
+    STATIC_REQUIRE(prefetch_distance<prefetch<3>> == 3);
+    STATIC_REQUIRE(prefetch_distance<prefetch<64> | zip_config::MOVE_FROM_RVALUES> == 64);
+
+    std::list<int> l(100);
+    std::iota(l.begin(), l.end(), 0);
+    std::map<int, int> m;
+    for (int i = 0; i < 50; ++i) {
+        m[i] = 2 * i;
+    }
+    std::vector<int> v(80, 1);
+
+    SECTION("Same rows") {
+        int expected = 0;
+        for (auto [x, kv, y] : zip(l, m, v)) {
+            expected += x * kv.second * y;
+        }
+        int actual = 0;
+        for (auto [x, kv, y] : zip<prefetch<4>>(l, m, v)) {
+            actual += x * kv.second * y;
+        }
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("Distance longer than the zip") {
+        std::list<int> small = {1, 2, 3};
+        int sum = 0;
+        for (auto [x, y] : zip<prefetch<16>>(small, l)) {
+            sum += x + y;
+        }
+        REQUIRE(sum == 1 + 2 + 3 + 0 + 1 + 2);
+    }
+
+    SECTION("Writes and copies") {
+        auto z = zip<zip_config::PREFETCH>(l, v);
+        auto it = z.begin();
+        auto copy = it;
+        for (; it != z.end(); ++it) {
+            auto&& [x, y] = *it;
+            y = x;
+        }
+        REQUIRE((*copy).get<0>() == 0);
+        REQUIRE(std::ranges::equal(v, std::views::iota(0, 80)));
+
+        it = copy;
+        std::advance(it, 10);
+        REQUIRE((*it).get<1>() == 10);
+    }
+
+    SECTION("Contiguous inputs are not prefetched") {
+        STATIC_REQUIRE(sizeof(zip<zip_config::PREFETCH>(v, v).begin()) == sizeof(zip(v, v).begin()));
+        STATIC_REQUIRE(sizeof(zip<zip_config::PREFETCH>(l, v).begin()) > sizeof(zip(l, v).begin()));
+    }
+}
+
+namespace {
+
+    // Chunks of `count` increasing numbers, `size` at a time
+    zip_utils::async::generator<std::vector<int>> numbers(int count, int size) {
+        for (int first = 0; first < count; first += size) {
+            std::vector<int> chunk;
+            for (int i = first; i < std::min(count, first + size); ++i) {
+                chunk.push_back(i);
+            }
+            co_yield std::move(chunk);
+        }
+    }
+
+    zip_utils::async::task<std::string> fetch_letters(int size) {
+        co_return std::string(static_cast<std::size_t>(size), 'x');
+    }
+
+    // Awaits every chunk from another coroutine before handing it over
+    zip_utils::async::generator<std::string> letters(int count, int size) {
+        for (int produced = 0; produced < count; produced += size) {
+            co_yield co_await fetch_letters(std::min(size, count - produced));
+        }
+    }
+
+    zip_utils::async::generator<std::vector<int>> failing_after(int chunks) {
+        for (int i = 0; i < chunks; ++i) {
+            co_yield std::vector<int>(1, i);
+        }
+        throw std::runtime_error("source failed");
+    }
+
+}  // namespace
+
+TEST_CASE("Async zip", "[async]") {
+    using zip_utils::async::sync_wait;
+    using zip_utils::async::task;
+
+    zip_utils::async::executor executor(2);
+
+    SECTION("Rows") {
+        auto consume = [&]() -> task<std::vector<int>> {
+            auto z = zip_utils::async::zip(executor, numbers(100, 7), numbers(90, 16), letters(95, 5));
+            std::vector<int> sums;
+            while (auto row = co_await z.next()) {
+                auto& [x, y, c] = *row;
+                REQUIRE(c == 'x');
+                sums.push_back(x + y);
+                x = -1;
+            }
+            co_return sums;
+        };
+
+        auto sums = sync_wait(consume());
+        REQUIRE(sums.size() == 90);
+        for (std::size_t i = 0; i < sums.size(); ++i) {
+            REQUIRE(sums[i] == static_cast<int>(2 * i));
+        }
+    }
+
+    SECTION("Chunks") {
+        auto consume = [&]() -> task<std::pair<std::size_t, int>> {
+            auto z = zip_utils::async::zip(executor, numbers(50, 20), numbers(50, 15));
+            std::size_t chunks = 0;
+            int sum = 0;
+            while (auto rows = co_await z.next_chunk()) {
+                ++chunks;
+                for (auto [x, y] : *rows) {
+                    sum += x * y;
+                }
+            }
+            co_return std::pair{chunks, sum};
+        };
+
+        auto [chunks, sum] = sync_wait(consume());
+        REQUIRE(chunks == 6);  // split at 15, 20, 30, 40, 45
+        int expected = 0;
+        for (int i = 0; i < 50; ++i) {
+            expected += i * i;
+        }
+        REQUIRE(sum == expected);
+    }
+
+    SECTION("Empty source") {
+        auto consume = [&]() -> task<int> {
+            auto z = zip_utils::async::zip(executor, numbers(0, 4), numbers(10, 4));
+            int rows = 0;
+            while (co_await z.next()) {
+                ++rows;
+            }
+            co_return rows;
+        };
+        REQUIRE(sync_wait(consume()) == 0);
+    }
+
+    SECTION("Producer exceptions reach the consumer") {
+        auto consume = [&]() -> task<int> {
+            auto z = zip_utils::async::zip(executor, failing_after(3), numbers(10, 1));
+            int rows = 0;
+            while (co_await z.next()) {
+                ++rows;
+            }
+            co_return rows;
+        };
+        REQUIRE_THROWS_AS(sync_wait(consume()), std::runtime_error);
+    }
+
+    SECTION("Abandoned stream") {
+        auto consume = [&]() -> task<int> {
+            auto z = zip_utils::async::zip(executor, numbers(1000, 10), numbers(1000, 3));
+            auto row = co_await z.next();
+            co_return (*row).get<0>();
+        };
+        REQUIRE(sync_wait(consume()) == 0);
+    }
+
+    SECTION("Abandoned on the only thread of the executor") {
+        // The consumer resumes on the executor thread, where the next chunks are still queued
+        zip_utils::async::executor single(1);
+        auto consume = [&]() -> task<int> {
+            auto z = zip_utils::async::zip(single, numbers(1000, 10), letters(1000, 3));
+            int sum = 0;
+            for (int i = 0; i < 25; ++i) {
+                auto row = co_await z.next();
+                sum += (*row).get<0>();
+            }
+            co_return sum;
+        };
+        REQUIRE(sync_wait(consume()) == 300);
+    }
+}
+
+TEST_CASE("Unzip", "[unzip]") {
+    using zip_utils::configuration::zip_config;
+
+    std::vector<std::pair<int, std::string>> rows;
+    for (int i = 0; i < 100; ++i) {
+        rows.emplace_back(i, std::string(32, static_cast<char>('a' + i % 26)));
+    }
+
+    SECTION("Sized input is reserved once") {
+        std::vector<int> numbers;
+        std::vector<std::string> names;
+        REQUIRE(zip_utils::unzip(rows, numbers, names) == 100);
+        REQUIRE(numbers.capacity() == 100);
+        REQUIRE(names.capacity() == 100);
+        REQUIRE(numbers[42] == 42);
+        REQUIRE(names[42] == rows[42].second);
+
+        zip_utils::unzip(rows, numbers, names);
+        REQUIRE(numbers.capacity() == 200);
+    }
+
+    SECTION("Filtered zip") {
+        std::vector<int> a = {1, 2, 3, 4, 5, 6};
+        std::list<char> b = {'a', 'b', 'c', 'd', 'e', 'f'};
+        auto even = zip(a, b) | std::views::filter([](auto const& row) {
+                        auto const& [x, y] = row;
+                        return x % 2 == 0;
+                    });
+
+        std::vector<int> numbers;
+        std::string letters;
+        REQUIRE(zip_utils::unzip(even, numbers, letters) == 3);
+        REQUIRE(numbers == std::vector<int>{2, 4, 6});
+        REQUIRE(letters == "bdf");
+    }
+
+    SECTION("Rvalues") {
+        std::vector<int> numbers;
+        std::vector<std::string> names;
+
+        zip_utils::unzip(std::move(rows), numbers, names);
+        REQUIRE(rows[0].second.size() == 32);  // copied by default
+
+        zip_utils::unzip<zip_config::MOVE_FROM_RVALUES>(std::move(rows), numbers, names);
+        REQUIRE(rows[0].second.empty());
+        REQUIRE(names[100] == names[0]);
+
+        std::vector<std::tuple<int, std::unique_ptr<int>>> owners(3);
+        std::vector<int> keys;
+        std::vector<std::unique_ptr<int>> pointers;
+        std::get<1>(owners[2]) = std::make_unique<int>(7);
+        zip_utils::unzip<zip_config::MOVE_FROM_RVALUES>(std::move(owners), keys, pointers);
+        REQUIRE(*pointers[2] == 7);
+        REQUIRE(std::get<1>(owners[2]) == nullptr);
+
+        std::vector<std::ranges::range_value_t<decltype(zip(keys, names))>> stored;
+        stored.emplace_back(1, std::string(32, 'y'));
+        zip_utils::unzip<zip_config::MOVE_FROM_RVALUES>(std::move(stored), keys, names);
+        REQUIRE(names.back().size() == 32);
+        REQUIRE(stored[0].get<1>().empty());
+    }
+
+    SECTION("Zips move by their own configuration") {
+        std::vector<std::string> source(4, std::string(32, 'x'));
+        std::vector<std::string> copies;
+        zip_utils::unzip<zip_config::MOVE_FROM_RVALUES>(zip(source), copies);
+        REQUIRE(source[0].size() == 32);
+
+        std::vector<std::string> moved;
+        zip_utils::unzip(zip<zip_config::MOVE_FROM_RVALUES>(std::move(source)), moved);
+        REQUIRE(moved.size() == 4);
+        REQUIRE(moved[0].size() == 32);
+    }
+
+    SECTION("Inserter") {
+        std::vector<int> a = {3, 1, 2};
+        std::vector<char> b = {'c', 'a', 'b'};
+        std::set<int> numbers;
+        std::string letters;
+        std::ranges::copy(zip(a, b), zip_utils::zip_inserter(numbers, letters));
+        REQUIRE(numbers == std::set<int>{1, 2, 3});
+        REQUIRE(letters == "cab");
+        STATIC_REQUIRE(std::output_iterator<decltype(zip_utils::zip_inserter(numbers, letters)), std::tuple<int, char>>);
+    }
+
+    SECTION("To columns") {
+        auto [numbers, names] = zip_utils::to_columns<std::deque<int>, std::vector<std::string>>(rows);
+        REQUIRE(numbers.size() == 100);
+        REQUIRE(names.back() == rows.back().second);
+    }
+}
+
+TEST_CASE("Compact layout", "[zip]") {
+    std::vector<int> a = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<double, 6> b = {10, 20, 30, 40, 50, 60};
+    std::string c = "abcdefgh";
+
+    SECTION("Random access") {
+        auto z = zip(a, b, c);
+        auto first = z.begin();
+        auto last = z.end();
+        REQUIRE(last - first == 6);
+        auto back = last - 1;
+        REQUIRE(first[5].get<1>() == 60);
+        REQUIRE((*back).get<2>() == 'f');
+        REQUIRE(first + 6 == last);
+        REQUIRE(first < last);
+
+        std::string reversed;
+        for (auto it = last; it != first;) {
+            --it;
+            auto [x, y, ch] = *it;
+            reversed += ch;
+        }
+        REQUIRE(reversed == "fedcba");
+    }
+
+    SECTION("Counters") {
+        int expected = 100;
+        for (auto [i, x] : zip(counter<int>(100, -10), a)) {
+            REQUIRE(i == expected);
+            expected -= 10;
+        }
+        auto e = enumerate<std::uint32_t>(a, c);
+        auto back = e.begin() + 7;
+        REQUIRE((*back).get<0>() == 7u);
+        REQUIRE(e.end() - e.begin() == 8);
+    }
+
+    SECTION("Sentinels") {
+        auto small = a | std::views::take_while([](int x) { return x < 4; });
+        STATIC_REQUIRE(std::ranges::contiguous_range<decltype(small)>);
+        int rows = 0;
+        for (auto [x, y] : zip(small, b)) {
+            REQUIRE(y == 10 * x);
+            ++rows;
+        }
+        REQUIRE(rows == 3);
+    }
+
+    SECTION("Sorting") {
+        std::vector<int> keys = {3, 1, 2};
+        std::vector<std::string> names = {"c", "a", "b"};
+        std::ranges::sort(zip(keys, names), {}, [](auto const& row) {
+            auto const& [key, name] = row;
+            return key;
+        });
+        REQUIRE(keys == std::vector<int>{1, 2, 3});
+        REQUIRE(names == std::vector<std::string>{"a", "b", "c"});
+    }
+}
+
+TEST_CASE("Merge join", "[merge_join]") {
+    using zip_utils::configuration::join_kind;
+
+    std::vector<int> left = {1, 2, 2, 4, 6, 7, 9};
+    std::vector<int> right = {2, 2, 3, 4, 5, 9, 9, 10};
+
+    SECTION("Inner") {
+        STATIC_REQUIRE(std::ranges::forward_range<decltype(merge_join(left, right))>);
+
+        std::vector<std::pair<int, int>> rows;
+        for (auto&& [x, y] : merge_join(left, right)) {
+            REQUIRE(&x >= left.data());
+            rows.emplace_back(x, y);
+        }
+        // equal keys give every combination
+        REQUIRE(rows == std::vector<std::pair<int, int>>{{2, 2}, {2, 2}, {2, 2}, {2, 2}, {4, 4}, {9, 9}, {9, 9}});
+        REQUIRE(std::ranges::distance(merge_join(right, left)) == 7);
+        REQUIRE(std::ranges::distance(merge_join(left, std::vector<int>{})) == 0);
+    }
+
+    SECTION("Left outer") {
+        std::vector<std::pair<int, int>> rows;
+        for (auto [x, y] : merge_join<join_kind::LEFT_OUTER>(left, right)) {
+            STATIC_REQUIRE(std::is_same_v<decltype(y), int*>);
+            rows.emplace_back(x, y ? *y : -1);
+        }
+        REQUIRE(rows == std::vector<std::pair<int, int>>{
+                            {1, -1}, {2, 2}, {2, 2}, {2, 2}, {2, 2}, {4, 4}, {6, -1}, {7, -1}, {9, 9}, {9, 9}});
+
+        auto none = merge_join<join_kind::LEFT_OUTER>(left, std::vector<int>{});
+        REQUIRE(std::ranges::distance(none) == 7);
+
+        // prvalue elements are returned as optionals
+        for (auto [x, y] : merge_join<join_kind::LEFT_OUTER>(left, std::views::iota(3, 6))) {
+            REQUIRE(y.has_value() == (x >= 3 && x < 6));
+        }
+    }
+
+    SECTION("Key projections") {
+        struct order {
+            int customer;
+            double amount;
+        };
+        std::vector<order> orders = {{1, 10.0}, {3, 5.0}, {3, 7.5}, {8, 1.0}};
+        std::map<int, std::string> customers = {{1, "ann"}, {2, "bob"}, {3, "cid"}};
+
+        std::vector<std::string> names;
+        double total = 0;
+        for (auto&& [o, c] : merge_join(orders, customers, &order::customer, [](auto const& kv) { return kv.first; })) {
+            names.push_back(c.second);
+            total += o.amount;
+            o.amount = 0;
+        }
+        REQUIRE(names == std::vector<std::string>{"ann", "cid", "cid"});
+        REQUIRE(total == 22.5);
+        REQUIRE(orders[1].amount == 0);
+        REQUIRE(orders[3].amount == 1.0);
+
+        std::list<int> ids = {2, 3, 4};
+        std::list<std::string> matched;
+        for (auto [id, c] : merge_join(ids, customers, std::identity{}, [](auto const& kv) { return kv.first; })) {
+            matched.push_back(c.second);
+        }
+        REQUIRE(matched == std::list<std::string>{"bob", "cid"});
+    }
+
+    SECTION("Galloping over sparse keys") {
+        std::vector<int> dense(100000);
+        std::iota(dense.begin(), dense.end(), 0);
+        std::vector<int> sparse = {-5, 17, 40000, 99999, 200000};
+
+        int projections = 0;
+        auto key = [&projections](int x) {
+            ++projections;
+            return x;
+        };
+
+        std::vector<int> found;
+        for (auto [x, y] : merge_join(sparse, dense, key)) {
+            found.push_back(y);
+        }
+        REQUIRE(found == std::vector<int>{17, 40000, 99999});
+        REQUIRE(projections < 1000);
+
+        projections = 0;
+        REQUIRE(std::ranges::distance(merge_join<join_kind::LEFT_OUTER>(sparse, dense, key)) == 5);
+        REQUIRE(projections < 1000);
+    }
+}
+
+TEST_CASE("Instrumentation", "[instrumentation]") {
+    using zip_utils::configuration::zip_config;
+    auto& registry = zip_utils::instrumentation::registry::global();
+    registry.reset();
+
+    auto site_at = [&](int line) {
+        auto const sites = registry.sites();
+        auto const it = std::ranges::find(sites, static_cast<std::uint_least32_t>(line),
+                                          &zip_utils::instrumentation::site_stats::line);
+        REQUIRE(it != sites.end());
+        return *it;
+    };
+
+    std::vector<int> a = {1, 2, 3, 4, 5};
+    std::deque<int> b = {1, 2, 3};
+
+    SECTION("Disabled") {
+        using iterator = decltype(zip(a, b).begin());
+        STATIC_REQUIRE(std::is_trivially_destructible_v<iterator>);
+        STATIC_REQUIRE(!std::is_trivially_destructible_v<decltype(zip<zip_config::INSTRUMENT>(a, b).begin())>);
+        for ([[maybe_unused]] auto&& row : zip(a, b)) {}
+        REQUIRE(registry.sites().empty());
+    }
+
+    SECTION("Sized inputs") {
+        int const line = __LINE__ + 2;
+        for (int i = 0; i < 2; ++i) {
+            for ([[maybe_unused]] auto&& row : zip<zip_config::INSTRUMENT>(a, b)) {}
+        }
+        auto const site = site_at(line);
+        REQUIRE(site.inputs == 2);
+        REQUIRE(site.iterations == 2);
+        REQUIRE(site.completed == 2);
+        REQUIRE(site.rows == 6);
+        REQUIRE(site.mismatches == 2);
+        REQUIRE(site.ended_first == std::vector<std::uint64_t>{0, 2});
+        REQUIRE(site.truncated_rows == 4);
+
+        int const partial_line = __LINE__ + 1;
+        for (auto [x, i] : zip<zip_config::INSTRUMENT>(a, counter())) {
+            if (x == 2) {
+                break;
+            }
+        }
+        auto const partial = site_at(partial_line);
+        REQUIRE(partial.completed == 0);
+        REQUIRE(partial.rows == 1);
+        REQUIRE(partial.mismatches == 0);
+    }
+
+    SECTION("Inputs of unknown size") {
+        std::forward_list<int> f = {1, 2};
+        auto small = a | std::views::take_while([](int x) { return x < 4; });
+
+        int const line = __LINE__ + 1;
+        for ([[maybe_unused]] auto&& row : zip<zip_config::INSTRUMENT>(b, f, small)) {}
+        auto const site = site_at(line);
+        REQUIRE(site.rows == 2);
+        REQUIRE(site.completed == 1);
+        REQUIRE(site.mismatches == 1);
+        REQUIRE(site.ended_first == std::vector<std::uint64_t>{0, 1, 0});
+        REQUIRE(site.truncated_rows == 1);
+
+        auto same = f;
+        for ([[maybe_unused]] auto&& row : zip<zip_config::INSTRUMENT>(f, same)) {}
+        REQUIRE(registry.sites().back().mismatches == 0);
+    }
+
+    SECTION("Algorithms and JSON") {
+        int const line = __LINE__ + 1;
+        auto z = zip<zip_config::INSTRUMENT>(a, b);
+        // the distance of a sized zip is computed without iterating
+        REQUIRE(std::ranges::distance(z.begin(), z.end()) == 3);
+        // iterations in library code are recorded where the zip is created
+        std::ranges::for_each(z, [](auto&&) {});
+        REQUIRE(registry.sites().size() == 1);
+        auto const site = site_at(line);
+        REQUIRE(std::string_view(site.file).ends_with("tests.cpp"));
+        REQUIRE(site.iterations == 2);
+        REQUIRE(site.rows == 3);
+
+        int const enumerated_line = __LINE__ + 1;
+        std::ranges::for_each(b | enumerate<zip_config::INSTRUMENT>(), [](auto&&) {});
+        REQUIRE(site_at(enumerated_line).inputs == 2);
+
+        std::ostringstream json;
+        registry.dump_json(json);
+        REQUIRE(json.str().starts_with("{\n  \"sites\": ["));
+        REQUIRE(json.str().find("\"ended_first\": [0, 2]") != std::string::npos);
+
+        registry.reset();
+        REQUIRE(registry.sites().empty());
+    }
+}
+
+TEST_CASE("Equal lengths", "[zip]") {
+    using zip_utils::configuration::zip_config;
+
+    std::forward_list<int> f = {1, 2, 3, 4};
+    std::vector<int> v = {0, 1, 2, 3, 4, 5, 6, 7};
+    auto odd = v | std::views::filter([](int x) { return x % 2 == 1; });
+
+    SECTION("Inputs of unknown size") {
+        std::vector<std::pair<int, int>> rows;
+        for (auto [x, y] : zip_equal(f, odd)) {
+            rows.emplace_back(x, y);
+        }
+        REQUIRE(rows == std::vector<std::pair<int, int>>{{1, 1}, {2, 3}, {3, 5}, {4, 7}});
+
+        auto z = zip_equal(f, odd);
+        auto it = z.begin();
+        auto next = std::next(it);
+        REQUIRE(it != next);
+        REQUIRE(std::next(it, 4) == z.end());
+    }
+
+    SECTION("Unbounded inputs are not the lead one") {
+        std::size_t rows = 0;
+        for (auto [i, x, y] : zip_equal(counter<int>(), f, odd)) {
+            REQUIRE(i == static_cast<int>(rows++));
+            REQUIRE(y == 2 * x - 1);
+        }
+        REQUIRE(rows == 4);
+        REQUIRE(std::ranges::distance(zip_equal(odd, std::views::iota(0))) == 4);
+    }
+
+    SECTION("Sized inputs") {
+        std::list<int> l = {4, 3, 2, 1};
+        auto z = zip_equal<zip_config::MOVE_FROM_RVALUES>(l, std::vector<int>{1, 2, 3, 4});
+        REQUIRE(z.size() == 4);
+        for (auto [x, y] : z) {
+            REQUIRE(x + y == 5);
+        }
+        std::array<int, 4> a = {1, 2, 3, 4};
+        REQUIRE(std::ranges::equal(zip_equal(a, v | std::views::take(4)) | std::views::transform([](auto const& row) {
+                                       auto const& [x, y] = row;
+                                       return x - y;
+                                   }),
+                                   std::vector<int>(4, 1)));
+    }
+}
+
+TEST_CASE("View", "[zip]") {
+    std::vector<int> v = {1, 2, 3, 4, 5, 6};
+    std::list<char> l = {'a', 'b', 'c', 'd'};
+
+    SECTION("Zips are views") {
+        using lvalues = decltype(zip(v, l));
+        using owning = decltype(zip(std::vector<int>{}, v));
+        STATIC_REQUIRE(std::ranges::view<lvalues>);
+        STATIC_REQUIRE(std::ranges::view<owning>);
+        STATIC_REQUIRE(std::ranges::view<decltype(enumerate(v))>);
+        STATIC_REQUIRE(std::copyable<lvalues>);
+        STATIC_REQUIRE(!std::copyable<owning>);
+        STATIC_REQUIRE(std::copyable<decltype(zip(std::views::iota(0), std::span(v)))>);
+        STATIC_REQUIRE(sizeof(lvalues) == 2 * sizeof(void*));
+        STATIC_REQUIRE(std::same_as<decltype(zip(v) | std::views::take(2)), std::ranges::take_view<decltype(zip(v))>>);
+
+        auto z = zip(v, l);
+        auto copy = z;
+        REQUIRE(std::ranges::equal(copy | std::views::transform([](auto const& row) { return row.template get<0>(); }),
+                                   v | std::views::take(4)));
+        std::vector<int> w = {7, 8};
+        copy = zip(w, l);
+        REQUIRE(std::ranges::distance(copy) == 2);
+        REQUIRE(std::ranges::distance(z) == 4);
+    }
+
+    SECTION("Borrowed ranges") {
+        STATIC_REQUIRE(std::ranges::borrowed_range<decltype(zip(v, l))>);
+        STATIC_REQUIRE(std::ranges::borrowed_range<decltype(enumerate(std::span(v)))>);
+        STATIC_REQUIRE(!std::ranges::borrowed_range<decltype(zip(std::vector<int>{}))>);
+
+        auto it = std::ranges::find_if(zip(v, l), [](auto const& row) { return row.template get<1>() == 'c'; });
+        auto&& [x, c] = *it;
+        REQUIRE(x == 3);
+        x = 30;
+        REQUIRE(v[2] == 30);
+    }
+
+    SECTION("Accessors return rows") {
+        auto z = zip(v, std::views::iota(10));
+        auto [first, ten] = z.front();
+        auto [sixth, fifteen] = z.back();
+        auto row = z[2];
+        auto& [third, twelve] = row;
+        REQUIRE(first == 1);
+        REQUIRE(sixth == 6);
+        REQUIRE(fifteen == 15);
+        REQUIRE(twelve == 12);
+        third = 0;
+        REQUIRE(v[2] == 0);
+        REQUIRE(!z.empty());
+        REQUIRE(zip(v, std::vector<int>{}).empty());
+    }
+
+    SECTION("Range adaptor closures") {
+        std::vector<std::size_t> indices;
+        for (auto&& [i, x] : v | enumerate()) {
+            indices.push_back(i);
+            x = 0;
+        }
+        REQUIRE(indices == std::vector<std::size_t>{0, 1, 2, 3, 4, 5});
+        REQUIRE(std::ranges::count(v, 0) == 6);
+
+        auto evens = l | enumerate<int>() | std::views::filter([](auto const& row) {
+                         auto const& [i, c] = row;
+                         return i % 2 == 0;
+                     }) |
+                     std::views::transform([](auto const& row) {
+                         auto const& [i, c] = row;
+                         return c;
+                     });
+        REQUIRE(std::ranges::equal(evens, "ac"sv));
+        REQUIRE(std::ranges::distance(l | zip() | std::views::drop(1)) == 3);
+    }
+}
+
+TEST_CASE("Adjacent", "[adjacent]") {
+    SECTION("Fibonacci") {
+        std::vector<int> f(10);
+        f[1] = 1;
+        for (auto&& [f0, f1, f2] : adjacent<3>(f)) {
+            f2 = f0 + f1;
+        }
+        REQUIRE(f == std::vector<int>{0, 1, 1, 2, 3, 5, 8, 13, 21, 34});
+    }
+
+    SECTION("Random access windows") {
+        std::vector<int> v = {1, 2, 3, 4, 5};
+        auto windows = adjacent<2>(v);
+        STATIC_REQUIRE(std::ranges::random_access_range<decltype(windows)>);
+        STATIC_REQUIRE(std::ranges::common_range<decltype(windows)>);
+        STATIC_REQUIRE(std::ranges::borrowed_range<decltype(windows)>);
+        STATIC_REQUIRE(std::ranges::view<decltype(windows)>);
+        REQUIRE(windows.size() == 4);
+        REQUIRE(windows.end() - windows.begin() == 4);
+
+        auto it = windows.begin() + 2;
+        auto&& [x, y] = *it;
+        REQUIRE(x == 3);
+        REQUIRE(y == 4);
+        auto&& [a, b] = it[1];
+        REQUIRE(a == 4);
+        REQUIRE(b == 5);
+        REQUIRE(it - 2 == windows.begin());
+        REQUIRE(windows.begin() < it);
+
+        auto const& constant = windows;
+        int sum = 0;
+        for (auto const& [p, q] : constant) {
+            sum += p * q;
+        }
+        REQUIRE(sum == 1 * 2 + 2 * 3 + 3 * 4 + 4 * 5);
+
+        REQUIRE(adjacent<5>(v).size() == 1);
+        REQUIRE(adjacent<6>(v).empty());
+        REQUIRE(adjacent<7>(std::vector<int>{}).size() == 0);
+    }
+
+    SECTION("Reverse") {
+        std::vector<int> v = {1, 2, 3, 4};
+        STATIC_REQUIRE(!std::is_reference_v<std::ranges::range_reference_t<decltype(adjacent<2>(v))>>);
+
+        std::vector<int> products;
+        for (auto [x, y] : adjacent<2>(v) | std::views::reverse) {
+            products.push_back(x * y);
+        }
+        REQUIRE(products == std::vector<int>{12, 6, 2});
+
+        auto rit = std::make_reverse_iterator(adjacent<2>(v).end());
+        auto [x, y] = rit[2];
+        REQUIRE((x == 1 && y == 2));
+    }
+
+    SECTION("Forward windows step each element once") {
+        std::forward_list<int> l = {1, 2, 3, 4, 5, 6};
+        int calls = 0;
+        auto counted = l | std::views::filter([&](int) {
+                           ++calls;
+                           return true;
+                       });
+        std::vector<int> sums;
+        for (auto const& [x, y, z] : adjacent<3>(counted)) {
+            sums.push_back(x + y + z);
+        }
+        REQUIRE(sums == std::vector<int>{6, 9, 12, 15});
+        REQUIRE(calls == 6);
+
+        STATIC_REQUIRE(std::ranges::forward_range<decltype(adjacent<3>(l))>);
+        REQUIRE(std::ranges::distance(adjacent<6>(l)) == 1);
+        REQUIRE(std::ranges::distance(adjacent<7>(l)) == 0);
+        REQUIRE(std::ranges::distance(adjacent<2>(std::forward_list<int>{})) == 0);
+
+        std::list<int> sized = {1, 2, 3};
+        REQUIRE(adjacent<2>(sized).size() == 2);
+    }
+
+    SECTION("Unbounded inputs") {
+        std::vector<std::pair<int, int>> pairs;
+        for (auto [x, y] : adjacent<2>(std::views::iota(0)) | std::views::take(3)) {
+            pairs.emplace_back(x, y);
+        }
+        REQUIRE(pairs == std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {2, 3}});
+    }
+
+    SECTION("Transform") {
+        std::vector<int> v = {1, 4, 9, 16};
+        REQUIRE(std::ranges::equal(adjacent_transform<2>(v, [](int x, int y) { return y - x; }), std::vector{3, 5, 7}));
+        REQUIRE(std::ranges::equal(v | adjacent_transform<3>([](int x, int y, int z) { return x + y + z; }),
+                                   std::vector{14, 29}));
+        REQUIRE(std::ranges::equal(std::list<int>{1, 2, 3} | adjacent_transform<2>(std::multiplies{}), std::vector{2, 6}));
+        REQUIRE(std::ranges::distance(v | adjacent<4>()) == 1);
+    }
+}